@@ -0,0 +1,467 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+#include <nanobench.h>
+
+#include <cstdint>
+#include <string>
+
+#include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/char_class.hpp>
+#include <lexy/engine/code_point.hpp>
+#include <lexy/engine/digits.hpp>
+#include <lexy/engine/literal.hpp>
+#include <lexy/engine/minus.hpp>
+#include <lexy/engine/trie.hpp>
+#include <lexy/engine/until.hpp>
+#include <lexy/engine/while.hpp>
+#include <lexy/input/buffer.hpp>
+
+//=== engines ===//
+namespace
+{
+constexpr auto operator_trie
+    = lexy::trie<char, LEXY_NTTP_STRING("+"), LEXY_NTTP_STRING("-"), LEXY_NTTP_STRING("*"),
+                 LEXY_NTTP_STRING("/"), LEXY_NTTP_STRING("<"), LEXY_NTTP_STRING(">"),
+                 LEXY_NTTP_STRING("="), LEXY_NTTP_STRING("!")>;
+constexpr auto operator_strie = lexy::shallow_trie<LEXY_NTTP_STRING("+-*/<>=!")>;
+constexpr auto operator_table = [] {
+    lexy::ascii_table<1> table;
+    for (auto c : "+-*/<>=!")
+        if (c != '\0')
+            table.insert(c, 0);
+    return table;
+}();
+
+constexpr auto return_ltrie = lexy::linear_trie<LEXY_NTTP_STRING("return")>;
+constexpr auto return_trie  = lexy::trie<char, LEXY_NTTP_STRING("return")>;
+
+#define LEXY_BENCHMARK_KEYWORDS(Macro)                                                             \
+    Macro("if"), Macro("else"), Macro("for"), Macro("while"), Macro("return"), Macro("break"),     \
+        Macro("continue"), Macro("switch")
+
+constexpr const char* keywords[] = {LEXY_BENCHMARK_KEYWORDS()};
+
+constexpr auto keyword_trie = lexy::trie<char, LEXY_BENCHMARK_KEYWORDS(LEXY_NTTP_STRING)>;
+
+template <typename String>
+constexpr auto keyword_ltrie = lexy::linear_trie<String>;
+
+// Tries each literal in turn, which is what we'd do without `engine_trie`.
+template <typename... Strings>
+struct engine_literal_alternative : lexy::engine_matcher_base
+{
+    enum class error_code
+    {
+        error = 1,
+    };
+
+    template <typename Reader>
+    static constexpr error_code match(Reader& reader)
+    {
+        auto match = (lexy::engine_try_match<lexy::engine_literal<keyword_ltrie<Strings>>>(reader)
+                      || ...);
+        return match ? error_code() : error_code::error;
+    }
+};
+using keyword_literals = engine_literal_alternative<LEXY_BENCHMARK_KEYWORDS(LEXY_NTTP_STRING)>;
+
+using lower_range          = lexy::engine_char_range<'a', 'z'>;
+constexpr auto lower_strie = lexy::shallow_trie<LEXY_NTTP_STRING("abcdefghijklmnopqrstuvwxyz")>;
+constexpr auto lower_table = [] {
+    lexy::ascii_table<1> table;
+    for (auto c = 'a'; c <= 'z'; ++c)
+        table.insert(c, 0);
+    return table;
+}();
+
+constexpr auto comment_end_ltrie = lexy::linear_trie<LEXY_NTTP_STRING("*/")>;
+using comment_end                = lexy::engine_literal<comment_end_ltrie>;
+
+using digit_set                 = lexy::engine_char_range<'0', '9'>;
+constexpr auto digit_zero_ltrie = lexy::linear_trie<LEXY_NTTP_STRING("0")>;
+using digit_zero                = lexy::engine_literal<digit_zero_ltrie>;
+constexpr auto digit_sep_ltrie  = lexy::linear_trie<LEXY_NTTP_STRING("'")>;
+using digit_sep                 = lexy::engine_literal<digit_sep_ltrie>;
+} // namespace
+
+//=== inputs ===//
+namespace
+{
+// xorshift64, we don't need anything fancy but want the same inputs everywhere.
+class prng
+{
+public:
+    explicit prng(std::uint64_t seed) : _state(seed) {}
+
+    std::uint64_t between(std::uint64_t min, std::uint64_t max)
+    {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return min + _state % (max - min + 1);
+    }
+
+private:
+    std::uint64_t _state;
+};
+
+// Generates an input of the given size consisting of items separated by the separator.
+template <typename Fn>
+std::string generate(std::size_t size, char separator, Fn item)
+{
+    prng        rng(size);
+    std::string result;
+    while (result.size() < size)
+    {
+        item(result, rng);
+        result.push_back(separator);
+    }
+    return result;
+}
+
+std::string operator_input(std::size_t size)
+{
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        str.push_back("+-*/<>=!"[rng.between(0, 7)]);
+    });
+}
+
+std::string return_input(std::size_t size)
+{
+    // Every fourth item only partially matches.
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        str += rng.between(0, 3) == 0 ? "retry" : "return";
+    });
+}
+
+std::string keyword_input(std::size_t size)
+{
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        str += keywords[rng.between(0, std::size(keywords) - 1)];
+    });
+}
+
+std::string identifier_input(std::size_t size)
+{
+    // Every fourth identifier is a keyword.
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        if (rng.between(0, 3) == 0)
+            str += keywords[rng.between(0, std::size(keywords) - 1)];
+        else
+        {
+            auto length = rng.between(1, 16);
+            for (auto i = 0u; i != length; ++i)
+                str.push_back(char('a' + rng.between(0, 25)));
+        }
+    });
+}
+
+std::string comment_input(std::size_t size)
+{
+    return generate(size, '\n', [](std::string& str, prng& rng) {
+        // Include some '*' and '/' that don't end the comment.
+        auto length = rng.between(0, 64);
+        for (auto i = 0u; i != length; ++i)
+        {
+            auto c = " abc*/xyz"[rng.between(0, 8)];
+            if (c == '/' && !str.empty() && str.back() == '*')
+                c = 'x';
+            str.push_back(c);
+        }
+        str += "*/";
+    });
+}
+
+std::string number_input(std::size_t size)
+{
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        str.push_back(char('1' + rng.between(0, 8)));
+        auto length = rng.between(0, 19);
+        for (auto i = 0u; i != length; ++i)
+            str.push_back(char('0' + rng.between(0, 9)));
+    });
+}
+
+std::string four_digit_input(std::size_t size)
+{
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        for (auto i = 0; i != 4; ++i)
+            str.push_back(char('0' + rng.between(0, 9)));
+    });
+}
+
+std::string ascii_text_input(std::size_t size)
+{
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        str += keywords[rng.between(0, std::size(keywords) - 1)];
+    });
+}
+
+std::string utf8_text_input(std::size_t size)
+{
+    // Mix of one, two, three and four byte code points.
+    return generate(size, ' ', [](std::string& str, prng& rng) {
+        const char* words[]
+            = {"lexy", "caf\xc3\xa9", "\xe6\x97\xa5\xe6\x9c\xac", "\xf0\x9f\x98\x80"};
+        str += words[rng.between(0, 3)];
+    });
+}
+
+template <typename Encoding = lexy::default_encoding>
+lexy::buffer<Encoding> make_buffer(const std::string& str)
+{
+    return lexy::buffer<Encoding>(str.data(), str.size());
+}
+
+// Repeatedly matches the engine on each item of the input, returns the number of matches.
+template <typename Engine, typename Encoding>
+std::size_t match_items(const lexy::buffer<Encoding>& input)
+{
+    auto count  = std::size_t(0);
+    auto reader = input.reader();
+    while (!reader.eof())
+    {
+        if (lexy::engine_try_match<Engine>(reader))
+            ++count;
+
+        // Skip the rest of the item as well as the separator.
+        while (!reader.eof() && reader.peek() != Encoding::to_int_type(' ')
+               && reader.peek() != Encoding::to_int_type('\n'))
+            reader.bump();
+        if (!reader.eof())
+            reader.bump();
+    }
+    return count;
+}
+} // namespace
+
+//=== output ===//
+const char* output_prefix()
+{
+    return R"(= Engine Benchmark
+
+// This file is automatically generated by `lexy_benchmark_engines`.
+// DO NOT MODIFY.
+
+This benchmark measures the time it takes to match the individual engines of `lexy/engine/`.
+Each input consists of many items separated by a space or newline;
+the engine is matched on each item, then the rest of the item and the separator are skipped.
+This is done for inputs of various sizes, the inputs are generated using a fixed seed.
+
+The average matching times for each input are shown in the boxplots below.
+Lower values are better.
+
+[pass]
+++++
+<script src="https://cdn.plot.ly/plotly-latest.min.js"></script>
+++++
+
+)";
+}
+
+const char* output_template()
+{
+    return R"(
+[pass]
+++++
+<div id="{{title}}"></div>
+<script>
+    var data = [
+        {{#result}}{
+            name: '{{name}}',
+            y: [{{#measurement}}{{elapsed}}{{^-last}}, {{/last}}{{/measurement}}],
+        },
+        {{/result}}
+    ];
+    var title = '{{title}}';
+
+    data = data.map(a => Object.assign(a, { boxpoints: 'all', pointpos: 0, type: 'box' }));
+    var layout = { title: { text: title }, showlegend: false, yaxis: { title: 'matching time', rangemode: 'tozero', autorange: true } };
+    Plotly.newPlot('{{title}}', data, layout, {responsive: true});
+</script>
+++++
+    )";
+}
+
+const char* output_suffix()
+{
+    return R"(
+.The inputs
+`operators`::
+    Single characters out of `+-*/<>=!`.
+    Matched by `engine_trie`, `engine_char_set` and `engine_ascii_table`.
+`return`::
+    The keyword `return`, every fourth item is `retry` instead, which only partially matches.
+    Matched by `engine_literal` and `engine_trie`.
+`keywords`::
+    One of eight keywords.
+    Matched by `engine_trie` and by trying one `engine_literal` per keyword.
+`identifiers`::
+    Lowercase identifiers of up to 16 characters, every fourth is a keyword.
+    Matched by `engine_while` of various character classes, and by `engine_minus` excluding the keywords.
+`comments`::
+    Up to 64 characters followed by `*/`.
+    Matched by `engine_until` and `engine_until_eof`.
+`numbers`::
+    Integers of up to 20 digits.
+    Matched by the `engine_digits` variants.
+`four digits`::
+    Integers of exactly four digits.
+    Matched by `engine_digits` and `engine_ndigits`.
+`code points`::
+    ASCII and UTF-8 text, where the entire input is matched by `engine_while` of a code point engine.
+
+.The Methodology
+The inputs are stored in a `lexy::buffer`.
+Benchmarking is done by https://nanobench.ankerl.com/[nanobench].
+    )";
+}
+
+int main()
+{
+    std::ofstream            out("benchmark_engines.adoc");
+    ankerl::nanobench::Bench b;
+
+    auto bench = [&](const char* name, std::size_t size, const auto& input, auto... engines) {
+        auto title = std::string(name) + " (" + std::to_string(size / 1024) + " KiB)";
+        b.title(title).relative(true);
+        b.unit("byte").batch(input.size());
+        b.minEpochIterations(10);
+
+        (b.run(engines.first, [&] { return engines.second(input); }), ...);
+
+        b.render(output_template(), out);
+    };
+    auto engine = [](const char* name, auto fn) { return std::make_pair(name, fn); };
+
+    out << output_prefix();
+    for (auto size : {std::size_t(4) * 1024, std::size_t(64) * 1024, std::size_t(1024) * 1024})
+    {
+        using buffer = lexy::buffer<lexy::default_encoding>;
+
+        bench("operators", size, make_buffer(operator_input(size)),
+              engine("engine_trie",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_trie<operator_trie>>(input);
+                     }),
+              engine("engine_char_set",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_char_set<operator_strie>>(input);
+                     }),
+              engine("engine_ascii_table", [](const buffer& input) {
+                  return match_items<lexy::engine_ascii_table<operator_table, 0>>(input);
+              }));
+
+        bench("return", size, make_buffer(return_input(size)),
+              engine("engine_literal",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_literal<return_ltrie>>(input);
+                     }),
+              engine("engine_trie", [](const buffer& input) {
+                  return match_items<lexy::engine_trie<return_trie>>(input);
+              }));
+
+        bench("keywords", size, make_buffer(keyword_input(size)),
+              engine("engine_trie",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_trie<keyword_trie>>(input);
+                     }),
+              engine("engine_literal", [](const buffer& input) {
+                  return match_items<keyword_literals>(input);
+              }));
+
+        bench("identifiers", size, make_buffer(identifier_input(size)),
+              engine("engine_while<engine_char_range>",
+                     [](const buffer& input) {
+                         using engine = lexy::engine_while<lower_range>;
+                         return match_items<engine>(input);
+                     }),
+              engine("engine_while<engine_char_set>",
+                     [](const buffer& input) {
+                         using engine = lexy::engine_while<lexy::engine_char_set<lower_strie>>;
+                         return match_items<engine>(input);
+                     }),
+              engine("engine_while<engine_ascii_table>",
+                     [](const buffer& input) {
+                         using engine
+                             = lexy::engine_while<lexy::engine_ascii_table<lower_table, 0>>;
+                         return match_items<engine>(input);
+                     }),
+              engine("engine_minus<..., engine_trie>",
+                     [](const buffer& input) {
+                         using engine = lexy::engine_minus<lexy::engine_while<lower_range>,
+                                                           lexy::engine_trie<keyword_trie>>;
+                         return match_items<engine>(input);
+                     }),
+              engine("engine_minus<..., engine_literal>", [](const buffer& input) {
+                  using engine
+                      = lexy::engine_minus<lexy::engine_while<lower_range>, keyword_literals>;
+                  return match_items<engine>(input);
+              }));
+
+        bench("comments", size, make_buffer(comment_input(size)),
+              engine("engine_until",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_until<comment_end>>(input);
+                     }),
+              engine("engine_until_eof", [](const buffer& input) {
+                  return match_items<lexy::engine_until_eof<comment_end>>(input);
+              }));
+
+        bench("numbers", size, make_buffer(number_input(size)),
+              engine("engine_digits",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_digits<digit_set>>(input);
+                     }),
+              engine("engine_digits_sep",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_digits_sep<digit_set, digit_sep>>(input);
+                     }),
+              engine("engine_digits_trimmed",
+                     [](const buffer& input) {
+                         using engine = lexy::engine_digits_trimmed<digit_set, digit_zero>;
+                         return match_items<engine>(input);
+                     }),
+              engine("engine_digits_trimmed_sep", [](const buffer& input) {
+                  using engine
+                      = lexy::engine_digits_trimmed_sep<digit_set, digit_zero, digit_sep>;
+                  return match_items<engine>(input);
+              }));
+
+        bench("four digits", size, make_buffer(four_digit_input(size)),
+              engine("engine_digits",
+                     [](const buffer& input) {
+                         return match_items<lexy::engine_digits<digit_set>>(input);
+                     }),
+              engine("engine_ndigits", [](const buffer& input) {
+                  return match_items<lexy::engine_ndigits<4, digit_set>>(input);
+              }));
+
+        {
+            auto ascii      = make_buffer<lexy::ascii_encoding>(ascii_text_input(size));
+            auto ascii_utf8 = make_buffer<lexy::utf8_encoding>(ascii_text_input(size));
+            auto utf8       = make_buffer<lexy::utf8_encoding>(utf8_text_input(size));
+
+            auto title = "code points (" + std::to_string(size / 1024) + " KiB)";
+            b.title(title).relative(true);
+            b.unit("byte").batch(ascii.size());
+            b.minEpochIterations(10);
+
+            b.run("engine_cp_ascii (ASCII)", [&] {
+                return match_items<lexy::engine_while<lexy::engine_cp_ascii>>(ascii);
+            });
+            b.run("engine_cp_utf8 (ASCII)", [&] {
+                return match_items<lexy::engine_while<lexy::engine_cp_utf8>>(ascii_utf8);
+            });
+            b.batch(utf8.size()).run("engine_cp_utf8 (UTF-8)", [&] {
+                return match_items<lexy::engine_while<lexy::engine_cp_utf8>>(utf8);
+            });
+
+            b.render(output_template(), out);
+        }
+    }
+    out << output_suffix();
+}
@@ -0,0 +1,168 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include "allocation.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<std::size_t> allocation_count{0};
+std::atomic<std::size_t> allocation_bytes{0};
+std::atomic<std::size_t> current_bytes{0};
+std::atomic<std::size_t> baseline_bytes{0};
+std::atomic<std::size_t> peak_bytes{0};
+
+// We store a header in front of the memory, so we know how much is freed.
+// The header preserves the alignment guarantee of malloc().
+constexpr auto header_size = alignof(std::max_align_t);
+
+struct header
+{
+    unsigned char* memory;
+    std::size_t    size;
+};
+static_assert(sizeof(header) <= header_size);
+
+void* allocate(std::size_t size, std::size_t alignment = header_size) noexcept
+{
+    // For over-aligned memory, we allocate more and align the memory after the header.
+    auto padding = alignment > header_size ? alignment - header_size : 0;
+    auto memory  = static_cast<unsigned char*>(std::malloc(header_size + padding + size));
+    if (memory == nullptr)
+        return nullptr;
+
+    auto address = reinterpret_cast<std::uintptr_t>(memory + header_size);
+    auto result  = memory + header_size + (alignment - address % alignment) % alignment;
+    reinterpret_cast<header*>(result)[-1] = {memory, size};
+
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    auto current = current_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak    = peak_bytes.load(std::memory_order_relaxed);
+    while (current > peak && !peak_bytes.compare_exchange_weak(peak, current))
+    {}
+
+    return result;
+}
+
+void deallocate(void* ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    auto h = static_cast<header*>(ptr)[-1];
+    current_bytes.fetch_sub(h.size, std::memory_order_relaxed);
+    std::free(h.memory);
+}
+} // namespace
+
+void reset_allocation_stats()
+{
+    allocation_count = 0;
+    allocation_bytes = 0;
+
+    auto current   = current_bytes.load();
+    baseline_bytes = current;
+    peak_bytes     = current;
+}
+
+allocation_stats get_allocation_stats()
+{
+    return {allocation_count.load(), allocation_bytes.load(),
+            peak_bytes.load() - baseline_bytes.load()};
+}
+
+void* operator new(std::size_t size)
+{
+    if (auto memory = allocate(size))
+        return memory;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+
+// Over-aligned allocations, e.g. from lexy's default memory resource.
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (auto memory = allocate(size, std::size_t(alignment)))
+        return memory;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, std::size_t(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, std::size_t(alignment));
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    deallocate(ptr);
+}
@@ -0,0 +1,25 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_BENCHMARK_JSON_ALLOCATION_HPP_INCLUDED
+#define LEXY_BENCHMARK_JSON_ALLOCATION_HPP_INCLUDED
+
+#include <cstddef>
+
+// The global operator new is replaced to record the following statistics.
+struct allocation_stats
+{
+    // The number of allocations and the total number of bytes allocated.
+    std::size_t count, bytes;
+    // The maximal number of bytes that were allocated at the same time.
+    std::size_t peak;
+};
+
+// Starts a new measurement, only allocations made afterwards are counted.
+void reset_allocation_stats();
+
+// Returns the statistics since the last reset.
+allocation_stats get_allocation_stats();
+
+#endif // LEXY_BENCHMARK_JSON_ALLOCATION_HPP_INCLUDED
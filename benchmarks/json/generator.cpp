@@ -0,0 +1,382 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+// Generates synthetic JSON documents for the benchmark.
+//
+// The output only depends on the kind, size and seed:
+// we use our own random number generator and distributions, as the ones of the standard library
+// are implementation-defined.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+// splitmix64, see http://prng.di.unimi.it/splitmix64.c
+class prng
+{
+public:
+    explicit prng(std::uint64_t seed) : _state(seed) {}
+
+    std::uint64_t next()
+    {
+        auto z = (_state += 0x9e3779b97f4a7c15);
+        z      = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z      = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    // Returns a number in [min, max].
+    std::uint64_t between(std::uint64_t min, std::uint64_t max)
+    {
+        return min + next() % (max - min + 1);
+    }
+
+    // Returns true with the given percentage.
+    bool chance(unsigned percent)
+    {
+        return next() % 100 < percent;
+    }
+
+    template <typename T, std::size_t N>
+    const T& pick(const T (&array)[N])
+    {
+        return array[next() % N];
+    }
+
+private:
+    std::uint64_t _state;
+};
+
+// Buffers the output and writes it in big chunks.
+class writer
+{
+public:
+    explicit writer(std::FILE* file) : _file(file), _size(0) {}
+
+    ~writer()
+    {
+        flush();
+    }
+
+    std::size_t size() const
+    {
+        return _size + _buffer.size();
+    }
+
+    void flush()
+    {
+        std::fwrite(_buffer.data(), 1, _buffer.size(), _file);
+        _size += _buffer.size();
+        _buffer.clear();
+    }
+
+    writer& operator<<(char c)
+    {
+        _buffer.push_back(c);
+        _maybe_flush();
+        return *this;
+    }
+    writer& operator<<(const char* str)
+    {
+        _buffer.append(str);
+        _maybe_flush();
+        return *this;
+    }
+    writer& operator<<(std::uint64_t value)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+        return *this << buffer;
+    }
+
+    void digits(prng& rng, unsigned count)
+    {
+        for (auto i = 0u; i != count; ++i)
+            _buffer.push_back(char('0' + rng.next() % 10));
+    }
+
+private:
+    void _maybe_flush()
+    {
+        if (_buffer.size() >= 64 * 1024)
+            flush();
+    }
+
+    std::FILE*  _file;
+    std::string _buffer;
+    std::size_t _size;
+};
+
+const char* const words[]
+    = {"the",   "of",      "and",    "lexy",     "parser",  "json",   "value",   "token",
+       "rule",  "grammar", "input",  "buffer",   "stream",  "event",  "concert", "venue",
+       "price", "seat",    "area",   "category", "name",    "user",   "status",  "followers",
+       "media", "url",     "string", "number",   "nested",  "object", "array",   "benchmark"};
+
+// Multi-byte UTF-8 words, as in the Japanese tweets of twitter.json.
+const char* const unicode_words[]
+    = {"\xe3\x81\x93\xe3\x82\x93\xe3\x81\xab\xe3\x81\xa1\xe3\x81\xaf", // こんにちは
+       "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e",                         // 日本語
+       "caf\xc3\xa9",                                                   // café
+       "\xc3\xbc\x62\x65\x72",                                          // über
+       "\xf0\x9f\x98\x80"};                                             // 😀
+
+const char* const escapes[] = {"\\n", "\\\"", "\\\\", "\\/", "\\t", "\\u00e9", "\\ud83d\\ude00"};
+
+// Writes a string of roughly the given number of words with occasional escapes and unicode.
+void write_text(writer& out, prng& rng, unsigned word_count, unsigned unicode_percent)
+{
+    out << '"';
+    for (auto i = 0u; i != word_count; ++i)
+    {
+        if (i > 0)
+            out << ' ';
+
+        if (rng.chance(unicode_percent))
+            out << rng.pick(unicode_words);
+        else
+            out << rng.pick(words);
+
+        if (rng.chance(5))
+            out << rng.pick(escapes);
+    }
+    out << '"';
+}
+
+// A number like in canada.json, e.g. -65.613616999999977.
+void write_coordinate(writer& out, prng& rng, std::uint64_t min, std::uint64_t max, bool negative)
+{
+    if (negative)
+        out << '-';
+    out << rng.between(min, max) << '.';
+    out.digits(rng, unsigned(rng.between(14, 15)));
+}
+
+//=== numbers ===//
+// Shaped like canada.json: a GeoJSON feature collection of polygons with lots of coordinates.
+void generate_numbers(writer& out, prng& rng, std::size_t size)
+{
+    out << R"({"type":"FeatureCollection","features":[)";
+    for (auto first_feature = true; out.size() < size; first_feature = false)
+    {
+        if (!first_feature)
+            out << ',';
+        out << R"({"type":"Feature","properties":{"name":)";
+        write_text(out, rng, 1, 0);
+        out << R"(},"geometry":{"type":"Polygon","coordinates":[)";
+
+        auto rings = rng.between(1, 8);
+        for (auto ring = 0u; ring != rings; ++ring)
+        {
+            if (ring > 0)
+                out << ',';
+            out << '[';
+
+            auto points = rng.between(16, 2048);
+            for (auto point = 0u; point != points && out.size() < size; ++point)
+            {
+                if (point > 0)
+                    out << ',';
+                out << '[';
+                write_coordinate(out, rng, 52, 141, true);
+                out << ',';
+                write_coordinate(out, rng, 41, 83, false);
+                out << ']';
+            }
+
+            out << ']';
+        }
+
+        out << "]}}";
+    }
+    out << "]}\n";
+}
+
+//=== strings ===//
+// Shaped like twitter.json: an array of status objects with lots of text.
+void write_user(writer& out, prng& rng)
+{
+    auto id = rng.between(1, 3'000'000'000);
+    out << R"({"id":)" << id << R"(,"id_str":")" << id << R"(","name":)";
+    write_text(out, rng, unsigned(rng.between(1, 3)), 30);
+    out << R"(,"screen_name":)";
+    write_text(out, rng, 1, 0);
+    out << R"(,"location":)";
+    write_text(out, rng, unsigned(rng.between(0, 3)), 20);
+    out << R"(,"description":)";
+    write_text(out, rng, unsigned(rng.between(0, 30)), 30);
+    out << R"(,"url":null,"protected":false,"followers_count":)" << rng.between(0, 100'000);
+    out << R"(,"friends_count":)" << rng.between(0, 10'000);
+    out << R"(,"created_at":"Sun Aug 31 00:29:15 +0000 2014","verified":)"
+        << (rng.chance(5) ? "true" : "false");
+    out << R"(,"lang":"ja"})";
+}
+
+void generate_strings(writer& out, prng& rng, std::size_t size)
+{
+    out << R"({"statuses":[)";
+
+    auto count = std::uint64_t(0);
+    for (; out.size() < size; ++count)
+    {
+        if (count > 0)
+            out << ',';
+
+        auto id = rng.between(500'000'000'000'000'000, 600'000'000'000'000'000);
+        out << R"({"metadata":{"result_type":"recent","iso_language_code":"ja"},"created_at":)";
+        out << R"("Sun Aug 31 00:29:15 +0000 2014","id":)" << id << R"(,"id_str":")" << id << '"';
+        out << R"(,"text":)";
+        write_text(out, rng, unsigned(rng.between(3, 40)), 40);
+        out << R"(,"source":"<a href=\"http:\/\/twitter.com\/download\/iphone\" )"
+            << R"(rel=\"nofollow\">Twitter for iPhone<\/a>","user":)";
+        write_user(out, rng);
+
+        out << R"(,"entities":{"hashtags":[)";
+        auto hashtags = rng.between(0, 3);
+        for (auto i = 0u; i != hashtags; ++i)
+        {
+            if (i > 0)
+                out << ',';
+            out << R"({"text":)";
+            write_text(out, rng, 1, 50);
+            auto begin = rng.between(0, 100);
+            out << R"(,"indices":[)" << begin << ',' << begin + rng.between(2, 10) << "]}";
+        }
+        out << R"(],"urls":[],"user_mentions":[]},"retweet_count":)" << rng.between(0, 1000);
+        out << R"(,"favorite_count":)" << rng.between(0, 1000);
+        out << R"(,"favorited":false,"retweeted":false,"lang":"ja"})";
+    }
+
+    out << R"(],"search_metadata":{"count":)" << count << "}}\n";
+}
+
+//=== nested ===//
+// Deeply nested objects and arrays, each level has some primitive siblings and one child.
+void write_primitive(writer& out, prng& rng)
+{
+    switch (rng.next() % 6)
+    {
+    case 0:
+        out << "null";
+        break;
+    case 1:
+        out << (rng.chance(50) ? "true" : "false");
+        break;
+    case 2:
+        out << rng.between(0, 1'000'000);
+        break;
+    case 3:
+        write_coordinate(out, rng, 0, 1000, rng.chance(50));
+        break;
+    default:
+        write_text(out, rng, unsigned(rng.between(0, 4)), 10);
+        break;
+    }
+}
+
+void write_nested(writer& out, prng& rng, unsigned depth)
+{
+    auto is_object = rng.chance(50);
+    auto siblings  = rng.between(0, 4);
+    auto child_idx = rng.between(0, siblings);
+
+    out << (is_object ? '{' : '[');
+    for (auto i = 0u; i <= siblings; ++i)
+    {
+        if (i > 0)
+            out << ',';
+        if (is_object)
+            out << R"("key)" << std::uint64_t(i) << R"(":)";
+
+        if (i != child_idx)
+            write_primitive(out, rng);
+        else if (depth > 1)
+            write_nested(out, rng, depth - 1);
+        else if (is_object)
+            out << "{}";
+        else
+            out << "[]";
+    }
+    out << (is_object ? '}' : ']');
+}
+
+void generate_nested(writer& out, prng& rng, std::size_t size)
+{
+    out << '[';
+    for (auto first = true; out.size() < size; first = false)
+    {
+        if (!first)
+            out << ',';
+        write_nested(out, rng, unsigned(rng.between(8, 64)));
+    }
+    out << "]\n";
+}
+
+// Parses sizes like 512K, 1M or 1G.
+std::size_t parse_size(const char* str)
+{
+    char* end  = nullptr;
+    auto  size = std::strtoull(str, &end, 10);
+    switch (*end)
+    {
+    case 'K':
+    case 'k':
+        return std::size_t(size) * 1024;
+    case 'M':
+    case 'm':
+        return std::size_t(size) * 1024 * 1024;
+    case 'G':
+    case 'g':
+        return std::size_t(size) * 1024 * 1024 * 1024;
+    default:
+        return std::size_t(size);
+    }
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::fprintf(stderr, "usage: %s <numbers|strings|nested> <size> <output> [seed]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    auto kind = argv[1];
+    auto size = parse_size(argv[2]);
+    auto seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 0;
+
+    auto file = std::fopen(argv[3], "wb");
+    if (!file)
+    {
+        std::fprintf(stderr, "unable to open '%s'\n", argv[3]);
+        return 1;
+    }
+
+    auto result = 0;
+    {
+        writer out(file);
+        prng   rng(seed);
+        if (std::strcmp(kind, "numbers") == 0)
+            generate_numbers(out, rng, size);
+        else if (std::strcmp(kind, "strings") == 0)
+            generate_strings(out, rng, size);
+        else if (std::strcmp(kind, "nested") == 0)
+            generate_nested(out, rng, size);
+        else
+        {
+            std::fprintf(stderr, "unknown kind '%s'\n", kind);
+            result = 1;
+        }
+    }
+
+    // Only close the file once `out` has flushed its buffer.
+    std::fclose(file);
+    return result;
+}
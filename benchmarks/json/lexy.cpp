@@ -13,3 +13,8 @@ bool json_lexy(const lexy::buffer<lexy::utf8_encoding>& input)
     return lexy::validate<grammar::json>(input, lexy::noop).has_value();
 }
 
+bool json_lexy_parse(const lexy::buffer<lexy::utf8_encoding>& input)
+{
+    // Parses into the DOM of the example, which is then destroyed again.
+    return lexy::parse<grammar::json>(input, lexy::noop).has_value();
+}
@@ -5,10 +5,13 @@
 #define ANKERL_NANOBENCH_IMPLEMENT
 #include <nanobench.h>
 
+#include "allocation.hpp"
+#include <cstdio>
 #include <lexy/input/file.hpp>
 
 bool json_baseline(const lexy::buffer<lexy::utf8_encoding>& input);
 bool json_lexy(const lexy::buffer<lexy::utf8_encoding>& input);
+bool json_lexy_parse(const lexy::buffer<lexy::utf8_encoding>& input);
 bool json_pegtl(const lexy::buffer<lexy::utf8_encoding>& input);
 bool json_nlohmann(const lexy::buffer<lexy::utf8_encoding>& input);
 bool json_rapid(const lexy::buffer<lexy::utf8_encoding>& input);
@@ -34,8 +37,12 @@ This benchmark measures the time it takes to *validate* JSON, i.e. to check whet
 Validation was chosen as opposed to parsing, as parsing speed depends on the JSON data structure as well.
 Implementing an efficient JSON container is out of scope for lexy, so it would have a disadvantage over the specialized JSON libraries.
 
+By default, the inputs are synthetic documents generated by `lexy_benchmark_json_generator`, so the benchmark works offline and the input size can be configured.
+
 The average validation times for each input are shown in the boxplots below.
 Lower values are better.
+For comparison, they also contain the time it takes lexy to *parse* the JSON into the DOM of the example.
+The memory used by validation and parsing is shown in the table at the end.
 
 [pass]
 ++++
@@ -62,7 +69,7 @@ const char* output_template()
     var title = '{{title}}';
 
     data = data.map(a => Object.assign(a, { boxpoints: 'all', pointpos: 0, type: 'box' }));
-    var layout = { title: { text: title }, showlegend: false, yaxis: { title: 'validation time', rangemode: 'tozero', autorange: true } };
+    var layout = { title: { text: title }, showlegend: false, yaxis: { title: 'validation/parse time', rangemode: 'tozero', autorange: true } };
     Plotly.newPlot('{{title}}', data, layout, {responsive: true});
 </script>
 ++++
@@ -77,16 +84,31 @@ const char* output_suffix()
     This simply adds all input characters of the JSON document without performing actual validation.
 `lexy`::
     A JSON validator using the lexy grammar from the example.
-`pegtl`::
+`lexy (parse)`::
+    A JSON parser using the lexy grammar and callbacks from the example, which creates a DOM of `std::map`, `std::vector` and `std::string`.
+)"
+#ifdef LEXY_BENCHMARK_JSON_COMPARE
+           R"(`pegtl`::
     A JSON validator using the https://github.com/taocpp/PEGTL[PEGTL] JSON grammar.
 `nlohmann/json`::
     A JSON validator using https://github.com/nlohmann/json[JSON for Modern C++] implemented by `nlohmann::json::accept()`.
 `rapidjson`::
     A JSON validator using https://github.com/Tencent/rapidjson[rapidjson] implemented using a SAX parser with the `rapidjson::BaseReaderHandler`.
-`Boost.JSON`::
+)"
+#    ifdef LEXY_HAS_BOOST_JSON
+           R"(`Boost.JSON`::
     A JSON validator using https://github.com/boostorg/json[Boost.JSON] implemented using a custom parse handler.
-
+)"
+#    endif
+#endif
+           R"(
 .The inputs
+`numbers-<size>.json`::
+    Generated like `canada.json`: GeoJSON polygons with lots of 2-element arrays holding floating-point coordinate pairs.
+`strings-<size>.json`::
+    Generated like `twitter.json`: status objects with lots of strings, including escape sequences and non-ASCII characters.
+`nested-<size>.json`::
+    Generated deeply nested arrays and objects of up to 64 levels with a mix of primitive values.
 `canada.json`::
     Contains lots of 2-element arrays holding floating-point coordinate pairs.
     Taken from https://github.com/miloyip/nativejson-benchmark.
@@ -97,18 +119,42 @@ const char* output_suffix()
     Some data from twitter's API.
     Taken from https://github.com/miloyip/nativejson-benchmark.
 
+The `<size>` of the generated inputs is controlled by the CMake option `LEXY_BENCHMARK_JSON_SIZE`, the seed by `LEXY_BENCHMARK_JSON_SEED`.
+The inputs from nativejson-benchmark are only used if `LEXY_BENCHMARK_JSON_DOWNLOAD` is enabled.
+
 .The Methodology
 The input data is read using `lexy::read_file()`.
 The resulting buffer is then passed to the various implementations using their memory inputs.
+Allocations are counted by replacing the global `operator new`,
+the peak memory is the maximal number of bytes allocated at the same time during one validation or parse, excluding the input.
 Benchmarking is done by https://nanobench.ankerl.com/[nanobench] on an AMD FX-6300.
     )";
 }
 
+// Returns a row of the allocation table.
+template <typename Fn>
+std::string allocation_row(const char* file, const char* name, std::size_t size, Fn fn)
+{
+    reset_allocation_stats();
+    fn();
+    auto stats = get_allocation_stats();
+
+    auto mb = double(size) / (1024 * 1024);
+
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "|%s |%s |%.0f |%.2f MiB |%.2f MiB\n", file, name,
+                  double(stats.count) / mb, double(stats.bytes) / (1024 * 1024) / mb,
+                  double(stats.peak) / (1024 * 1024));
+    return buffer;
+}
+
 int main()
 {
     std::ofstream            out("benchmark_json.adoc");
     ankerl::nanobench::Bench b;
 
+    std::string allocations;
+
     auto bench_data = [&](const char* file) {
         auto data = get_data(file);
 
@@ -118,20 +164,39 @@ int main()
 
         b.run("baseline", [&] { return json_baseline(data); });
         b.run("lexy", [&] { return json_lexy(data); });
+        b.run("lexy (parse)", [&] { return json_lexy_parse(data); });
+#ifdef LEXY_BENCHMARK_JSON_COMPARE
         b.run("pegtl", [&] { return json_pegtl(data); });
         b.run("nlohmann/json", [&] { return json_nlohmann(data); });
         b.run("rapidjson", [&] { return json_rapid(data); });
+#endif
 #ifdef LEXY_HAS_BOOST_JSON
         b.run("Boost.JSON", [&] { return json_boost(data); });
 #endif
 
         b.render(output_template(), out);
+
+        allocations += allocation_row(file, "lexy", data.size(), [&] { json_lexy(data); });
+        allocations += allocation_row(file, "lexy (parse)", data.size(),
+                                      [&] { json_lexy_parse(data); });
     };
 
     out << output_prefix();
+    bench_data("numbers-" LEXY_BENCHMARK_JSON_SIZE ".json");
+    bench_data("strings-" LEXY_BENCHMARK_JSON_SIZE ".json");
+    bench_data("nested-" LEXY_BENCHMARK_JSON_SIZE ".json");
+#ifdef LEXY_BENCHMARK_JSON_DOWNLOAD
     bench_data("canada.json");
     bench_data("citm_catalog.json");
     bench_data("twitter.json");
+#endif
+
+    out << "\n.Memory usage\n";
+    out << "[cols=\"2,2,>1,>1,>1\", options=\"header\"]\n|===\n";
+    out << "|Input |Implementation |Allocations per MiB |Allocated per MiB |Peak memory\n";
+    out << allocations;
+    out << "|===\n";
+
     out << output_suffix();
 }
 
@@ -0,0 +1,166 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+#include <nanobench.h>
+
+#include <cstdint>
+#include <string>
+
+#include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/char_class.hpp>
+#include <lexy/engine/while.hpp>
+#include <lexy/find.hpp>
+#include <lexy/input/buffer.hpp>
+#include <lexy/memory_resource.hpp>
+
+namespace
+{
+using buffer = lexy::buffer<lexy::default_encoding, lexy::huge_page_resource>;
+
+// Lines of lowercase words; the size and seed are fixed.
+std::string generate(std::size_t size)
+{
+    std::uint64_t state = size;
+    std::string   result;
+    result.reserve(size + 64);
+    while (result.size() < size)
+    {
+        // xorshift64, we don't need anything fancy.
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        result.append(state % 16 + 1, char('a' + state % 26));
+        result.push_back(state % 8 == 0 ? '\n' : ' ');
+    }
+    return result;
+}
+
+// Counts the newlines using SIMD.
+std::size_t count_lines(const buffer& input)
+{
+    auto begin = reinterpret_cast<const unsigned char*>(input.data());
+    return lexy::_detail::count_code_unit(begin, begin + input.size(), '\n');
+}
+
+// Bumps the reader over every character.
+std::size_t count_words(const buffer& input)
+{
+    using word = lexy::engine_while<lexy::engine_char_range<'a', 'z'>>;
+
+    auto count  = std::size_t(0);
+    auto reader = input.reader();
+    while (!reader.eof())
+    {
+        auto begin = reader.cur();
+        lexy::engine_try_match<word>(reader);
+        if (reader.cur() != begin)
+            ++count;
+        else
+            reader.bump();
+    }
+    return count;
+}
+} // namespace
+
+//=== output ===//
+const char* output_prefix()
+{
+    return R"(= Memory Benchmark
+
+// This file is automatically generated by `lexy_benchmark_memory`.
+// DO NOT MODIFY.
+
+This benchmark measures how the memory backing a `lexy::buffer` affects linear scans of big inputs.
+The same input is stored once in memory from `new`, and once in memory from `lexy::huge_page_resource`.
+With huge pages, a scan needs far fewer TLB entries.
+
+The average scanning times for each input are shown in the boxplots below.
+Lower values are better.
+
+[pass]
+++++
+<script src="https://cdn.plot.ly/plotly-latest.min.js"></script>
+++++
+
+)";
+}
+
+const char* output_template()
+{
+    return R"(
+[pass]
+++++
+<div id="{{title}}"></div>
+<script>
+    var data = [
+        {{#result}}{
+            name: '{{name}}',
+            y: [{{#measurement}}{{elapsed}}{{^-last}}, {{/last}}{{/measurement}}],
+        },
+        {{/result}}
+    ];
+    var title = '{{title}}';
+
+    data = data.map(a => Object.assign(a, { boxpoints: 'all', pointpos: 0, type: 'box' }));
+    var layout = { title: { text: title }, showlegend: false, yaxis: { title: 'scanning time', rangemode: 'tozero', autorange: true } };
+    Plotly.newPlot('{{title}}', data, layout, {responsive: true});
+</script>
+++++
+    )";
+}
+
+const char* output_suffix()
+{
+    return R"(
+.The scans
+`lines`::
+    Counts the newlines using SIMD.
+`words`::
+    Matches words using `engine_while`, which bumps the reader over every character.
+
+.The inputs
+Lines of lowercase words, generated using a fixed seed.
+
+.The Methodology
+Huge pages are only used if the system provides them: either explicit huge pages reserved using `vm.nr_hugepages`, or transparent huge pages enabled for `madvise`.
+Otherwise, both variants use normal pages.
+Benchmarking is done by https://nanobench.ankerl.com/[nanobench].
+    )";
+}
+
+int main()
+{
+    std::ofstream            out("benchmark_memory.adoc");
+    ankerl::nanobench::Bench b;
+
+    // Never uses huge pages.
+    lexy::huge_page_resource normal_pages(std::size_t(-1));
+    // Uses huge pages for the inputs.
+    lexy::huge_page_resource huge_pages;
+
+    out << output_prefix();
+    for (auto size : {std::size_t(64) << 20, std::size_t(256) << 20})
+    {
+        auto str    = generate(size);
+        auto normal = buffer(str.data(), str.size(), &normal_pages);
+        auto huge   = buffer(str.data(), str.size(), &huge_pages);
+
+        auto bench = [&](const char* name, auto scan) {
+            b.title(std::string(name) + " (" + std::to_string(size >> 20) + " MiB)")
+                .relative(true);
+            b.unit("byte").batch(size);
+            b.minEpochIterations(5);
+
+            b.run("new", [&] { return scan(normal); });
+            b.run("lexy::huge_page_resource", [&] { return scan(huge); });
+
+            b.render(output_template(), out);
+        };
+        bench("lines", count_lines);
+        bench("words", count_words);
+    }
+    out << output_suffix();
+}
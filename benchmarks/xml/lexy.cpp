@@ -0,0 +1,20 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/input/buffer.hpp>
+#include <lexy/validate.hpp>
+
+#define LEXY_TEST
+#include "../../examples/xml.cpp"
+
+bool xml_lexy(const lexy::buffer<lexy::utf8_encoding>& input)
+{
+    return lexy::validate<grammar::document>(input, lexy::noop).has_value();
+}
+
+bool xml_lexy_parse(const lexy::buffer<lexy::utf8_encoding>& input)
+{
+    // Parses into the tree of the example, which is then destroyed again.
+    return lexy::parse<grammar::document>(input, lexy::noop).has_value();
+}
@@ -0,0 +1,265 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#define ANKERL_NANOBENCH_IMPLEMENT
+#include <nanobench.h>
+
+#include <cstdint>
+#include <string>
+
+#include <lexy/input/buffer.hpp>
+
+bool xml_lexy(const lexy::buffer<lexy::utf8_encoding>& input);
+bool xml_lexy_parse(const lexy::buffer<lexy::utf8_encoding>& input);
+
+//=== generator ===//
+namespace
+{
+// xorshift64, we don't need anything fancy but want the same documents everywhere.
+class prng
+{
+public:
+    explicit prng(std::uint64_t seed) : _state(seed) {}
+
+    std::uint64_t between(std::uint64_t min, std::uint64_t max)
+    {
+        _state ^= _state << 13;
+        _state ^= _state >> 7;
+        _state ^= _state << 17;
+        return min + _state % (max - min + 1);
+    }
+
+    bool chance(unsigned percent)
+    {
+        return between(0, 99) < percent;
+    }
+
+    template <typename T, std::size_t N>
+    const T& pick(const T (&array)[N])
+    {
+        return array[between(0, N - 1)];
+    }
+
+private:
+    std::uint64_t _state;
+};
+
+const char* const tags[]
+    = {"item", "entry", "p", "section", "title", "x:data", "my-tag", "a.b", "_id"};
+
+const char* const words[] = {"lorem", "ipsum", "dolor", "sit",   "amet",     "lexy",
+                             "xml",   "tag",   "text",  "value", "document", "caf\xc3\xa9",
+                             "\xe6\x97\xa5\xe6\x9c\xac"};
+
+const char* const references[] = {"&quot;", "&amp;", "&apos;", "&lt;", "&gt;"};
+
+struct document_shape
+{
+    // The percentage of content that is text, a reference, a comment or CDATA;
+    // the rest are child elements.
+    unsigned text, reference, comment, cdata;
+    // The maximal depth and number of children of an element.
+    unsigned max_depth, max_children;
+    // The maximal number of words of text, comments and CDATA.
+    unsigned max_words;
+};
+
+class generator
+{
+public:
+    explicit generator(document_shape s) : _shape(s), _rng(42), _size(0) {}
+
+    std::string document(std::size_t size)
+    {
+        _size = size;
+        _result.clear();
+        _result += "<!-- generated -->\n<document>\n";
+        while (_result.size() < size)
+        {
+            _element(1);
+            _result.push_back('\n');
+        }
+        _result += "</document>\n";
+        return _result;
+    }
+
+private:
+    void _words()
+    {
+        auto count = _rng.between(1, _shape.max_words);
+        for (auto i = 0u; i != count; ++i)
+        {
+            if (i > 0)
+                _result.push_back(' ');
+            _result += _rng.pick(words);
+        }
+    }
+
+    void _element(unsigned depth)
+    {
+        auto tag = _rng.pick(tags);
+        _result.push_back('<');
+        _result += tag;
+
+        auto children = _rng.between(0, _shape.max_children);
+        if (depth >= _shape.max_depth || _result.size() >= _size)
+            children = 0;
+        if (children == 0 && _rng.chance(50))
+        {
+            _result += _rng.chance(50) ? "/>" : " />";
+            return;
+        }
+        _result.push_back('>');
+
+        for (auto i = 0u; i != children; ++i)
+        {
+            auto kind = _rng.between(0, 99);
+            if (kind < _shape.text)
+                _words();
+            else if ((kind -= _shape.text) < _shape.reference)
+                _result += _rng.pick(references);
+            else if ((kind -= _shape.reference) < _shape.comment)
+            {
+                _result += "<!-- ";
+                _words();
+                _result += " -->";
+            }
+            else if ((kind -= _shape.comment) < _shape.cdata)
+            {
+                _result += "<![CDATA[";
+                _words();
+                _result += " <&> ]]>";
+            }
+            else
+                _element(depth + 1);
+        }
+
+        _result += "</";
+        _result += tag;
+        _result.push_back('>');
+    }
+
+    document_shape _shape;
+    prng           _rng;
+    std::size_t    _size;
+    std::string    _result;
+};
+
+// The grammar of the example doesn't support attributes,
+// so the markup heavy shape consists of lots of small and empty elements instead.
+constexpr struct
+{
+    const char*    name;
+    document_shape shape;
+} shapes[] = {
+    {"balanced", {30, 5, 5, 5, 8, 6, 8}},
+    {"deep", {10, 5, 5, 0, 200, 3, 4}},
+    {"markup", {5, 20, 0, 0, 4, 12, 2}},
+    {"text", {80, 10, 0, 5, 4, 4, 64}},
+    {"comments", {10, 0, 60, 0, 4, 8, 32}},
+};
+} // namespace
+
+//=== output ===//
+const char* output_prefix()
+{
+    return R"(= XML Benchmark
+
+// This file is automatically generated by `lexy_benchmark_xml`.
+// DO NOT MODIFY.
+
+This benchmark measures the time it takes to *validate* and *parse* XML using the grammar of the XML example.
+Parsing creates the tree of the example, which requires a lot of allocations.
+
+The average validation and parse times for each input are shown in the boxplots below.
+Lower values are better.
+
+[pass]
+++++
+<script src="https://cdn.plot.ly/plotly-latest.min.js"></script>
+++++
+
+)";
+}
+
+const char* output_template()
+{
+    return R"(
+[pass]
+++++
+<div id="{{title}}"></div>
+<script>
+    var data = [
+        {{#result}}{
+            name: '{{name}}',
+            y: [{{#measurement}}{{elapsed}}{{^-last}}, {{/last}}{{/measurement}}],
+        },
+        {{/result}}
+    ];
+    var title = '{{title}}';
+
+    data = data.map(a => Object.assign(a, { boxpoints: 'all', pointpos: 0, type: 'box' }));
+    var layout = { title: { text: title }, showlegend: false, yaxis: { title: 'validation/parse time', rangemode: 'tozero', autorange: true } };
+    Plotly.newPlot('{{title}}', data, layout, {responsive: true});
+</script>
+++++
+    )";
+}
+
+const char* output_suffix()
+{
+    return R"(
+.The implementations
+`lexy`::
+    An XML validator using the lexy grammar from the example.
+`lexy (parse)`::
+    An XML parser using the lexy grammar and callbacks from the example.
+
+.The inputs
+The inputs are generated by the benchmark itself using a fixed seed; they are 1 MiB big.
+Each input is a document element with lots of child elements, which contain text, entity references, comments, CDATA sections and child elements.
+The proportions are different for each input.
+
+`balanced`::
+    A mix of everything with moderate nesting.
+`deep`::
+    Elements nested up to 200 levels deep.
+`markup`::
+    Lots of small and empty elements, as well as entity references.
+    The grammar of the example doesn't support attributes.
+`text`::
+    Long text, interspersed with entity references and CDATA sections.
+`comments`::
+    Mostly comments.
+
+.The Methodology
+The input data is generated into a `lexy::buffer`.
+Benchmarking is done by https://nanobench.ankerl.com/[nanobench].
+    )";
+}
+
+int main()
+{
+    std::ofstream            out("benchmark_xml.adoc");
+    ankerl::nanobench::Bench b;
+
+    out << output_prefix();
+    for (auto& s : shapes)
+    {
+        auto str  = generator(s.shape).document(1024 * 1024);
+        auto data = lexy::buffer<lexy::utf8_encoding>(str.data(), str.size());
+        if (!xml_lexy(data))
+            throw std::runtime_error("generated invalid document");
+
+        b.title(s.name).relative(true);
+        b.unit("byte").batch(data.size());
+        b.minEpochIterations(10);
+
+        b.run("lexy", [&] { return xml_lexy(data); });
+        b.run("lexy (parse)", [&] { return xml_lexy_parse(data); });
+
+        b.render(output_template(), out);
+    }
+    out << output_suffix();
+}
@@ -0,0 +1,126 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_DETAIL_BYTE_SWAP_HPP_INCLUDED
+#define LEXY_DETAIL_BYTE_SWAP_HPP_INCLUDED
+
+#include <cstring>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/simd.hpp>
+
+namespace lexy::_detail
+{
+template <typename T>
+constexpr T byte_swap(T value) noexcept
+{
+    static_assert(sizeof(T) == 2 || sizeof(T) == 4);
+    if constexpr (sizeof(T) == 2)
+        return static_cast<T>(((value & 0xFF) << 8) | (value >> 8));
+    else
+        return static_cast<T>((value << 24) | ((value & 0xFF00) << 8) | ((value >> 8) & 0xFF00)
+                              | (value >> 24));
+}
+
+#if LEXY_HAS_SSE2
+// Swaps the bytes in blocks of 16 bytes and returns the number of bytes swapped.
+// Without pshufb, we swap the 16 bit halves first and then the bytes of each half.
+template <std::size_t Size>
+std::size_t sse2_byte_swap(unsigned char* out, const unsigned char* src, std::size_t bytes) noexcept
+{
+    auto i = std::size_t(0);
+    for (; bytes - i >= 16; i += 16)
+    {
+        auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if constexpr (Size == 4)
+            data = _mm_shufflehi_epi16(_mm_shufflelo_epi16(data, 0xB1), 0xB1);
+        data = _mm_or_si128(_mm_slli_epi16(data, 8), _mm_srli_epi16(data, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), data);
+    }
+    return i;
+}
+#endif
+
+#if LEXY_HAS_SSSE3 || LEXY_HAS_AVX2
+// The shuffle mask that reverses the bytes of each code unit in a block of 16 bytes.
+template <std::size_t Size>
+LEXY_SIMD_TARGET("ssse3")
+__m128i ssse3_byte_swap_mask() noexcept
+{
+    if constexpr (Size == 2)
+        return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    else
+        return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+}
+
+template <std::size_t Size>
+LEXY_SIMD_TARGET("ssse3")
+std::size_t ssse3_byte_swap(unsigned char* out, const unsigned char* src,
+                            std::size_t bytes) noexcept
+{
+    const auto mask = ssse3_byte_swap_mask<Size>();
+
+    auto i = std::size_t(0);
+    for (; bytes - i >= 16; i += 16)
+    {
+        auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(data, mask));
+    }
+    return i;
+}
+#endif
+
+#if LEXY_HAS_AVX2
+template <std::size_t Size>
+LEXY_SIMD_TARGET("avx2")
+std::size_t avx2_byte_swap(unsigned char* out, const unsigned char* src, std::size_t bytes) noexcept
+{
+    // vpshufb shuffles within each 128 bit lane, so we use the same mask for both lanes.
+    const auto mask = _mm256_broadcastsi128_si256(ssse3_byte_swap_mask<Size>());
+
+    auto i = std::size_t(0);
+    for (; bytes - i >= 32; i += 32)
+    {
+        auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_shuffle_epi8(data, mask));
+    }
+    return i;
+}
+#endif
+
+/// Copies `count` code units from `src` to `dest` and reverses the bytes of each.
+/// The memory may overlap if `dest` is equal to `src`, which swaps in place.
+template <typename CharT>
+void copy_byte_swapped(CharT* dest, const unsigned char* src, std::size_t count) noexcept
+{
+    static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4);
+    auto       out   = reinterpret_cast<unsigned char*>(dest);
+    const auto bytes = count * sizeof(CharT);
+    auto       i     = std::size_t(0);
+
+    // Each kernel swaps as many blocks as it can, the next one continues with the rest.
+    [[maybe_unused]] const auto level = host_simd_level();
+#if LEXY_HAS_AVX2
+    if (level >= simd_level::avx2)
+        i += avx2_byte_swap<sizeof(CharT)>(out + i, src + i, bytes - i);
+#endif
+#if LEXY_HAS_SSSE3
+    if (level >= simd_level::ssse3)
+        i += ssse3_byte_swap<sizeof(CharT)>(out + i, src + i, bytes - i);
+#endif
+#if LEXY_HAS_SSE2
+    if (level >= simd_level::sse2)
+        i += sse2_byte_swap<sizeof(CharT)>(out + i, src + i, bytes - i);
+#endif
+
+    for (; i != bytes; i += sizeof(CharT))
+    {
+        CharT value;
+        std::memcpy(&value, src + i, sizeof(CharT));
+        value = byte_swap(value);
+        std::memcpy(out + i, &value, sizeof(CharT));
+    }
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_BYTE_SWAP_HPP_INCLUDED
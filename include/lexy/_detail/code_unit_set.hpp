@@ -0,0 +1,83 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_DETAIL_CODE_UNIT_SET_HPP_INCLUDED
+#define LEXY_DETAIL_CODE_UNIT_SET_HPP_INCLUDED
+
+#include <lexy/_detail/config.hpp>
+
+namespace lexy::_detail
+{
+/// A set of byte sized code units, i.e. the values of `unsigned char`.
+class code_unit_set
+{
+public:
+    constexpr code_unit_set() noexcept : _table() {}
+
+    static constexpr code_unit_set all() noexcept
+    {
+        code_unit_set result;
+        result.insert_range(0x00, 0xFF);
+        return result;
+    }
+
+    constexpr void insert(unsigned char c) noexcept
+    {
+        _table[c] = true;
+    }
+    constexpr void insert_range(unsigned char min, unsigned char max) noexcept
+    {
+        for (auto c = unsigned(min); c <= max; ++c)
+            _table[c] = true;
+    }
+    constexpr void insert(const code_unit_set& other) noexcept
+    {
+        for (auto c = 0u; c != 0x100; ++c)
+            _table[c] = _table[c] || other._table[c];
+    }
+
+    constexpr bool contains(unsigned char c) const noexcept
+    {
+        return _table[c];
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        auto result = std::size_t(0);
+        for (auto c = 0u; c != 0x100; ++c)
+            if (_table[c])
+                ++result;
+        return result;
+    }
+
+    /// The number of maximal ranges [min, max] of consecutive code units in the set.
+    constexpr std::size_t range_count() const noexcept
+    {
+        auto result = std::size_t(0);
+        for (auto c = 0u; c != 0x100; ++c)
+            if (_table[c] && (c == 0 || !_table[c - 1]))
+                ++result;
+        return result;
+    }
+    constexpr unsigned char range_min(std::size_t idx) const noexcept
+    {
+        for (auto c = 0u; c != 0x100; ++c)
+            if (_table[c] && (c == 0 || !_table[c - 1]) && idx-- == 0)
+                return static_cast<unsigned char>(c);
+        return 0;
+    }
+    constexpr unsigned char range_max(std::size_t idx) const noexcept
+    {
+        for (auto c = 0u; c != 0x100; ++c)
+            if (_table[c] && (c == 0xFF || !_table[c + 1]) && idx-- == 0)
+                return static_cast<unsigned char>(c);
+        return 0;
+    }
+
+private:
+    bool _table[0x100];
+};
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_CODE_UNIT_SET_HPP_INCLUDED
@@ -133,6 +133,74 @@ struct _char8_str
 #    endif
 #endif
 
+//=== simd ===//
+// Whether the kernels for an instruction set are compiled.
+// With LEXY_HAS_SIMD_DISPATCH, all of them are compiled and selected at runtime depending on the
+// CPU, see `lexy/_detail/simd.hpp`; otherwise, only the ones the compiler targets.
+#ifndef LEXY_HAS_SSE2
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define LEXY_HAS_SSE2 1
+#    else
+#        define LEXY_HAS_SSE2 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_SIMD_DISPATCH
+#    if LEXY_HAS_SSE2                                                                              \
+        && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))      \
+        && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#        define LEXY_HAS_SIMD_DISPATCH 1
+#    else
+#        define LEXY_HAS_SIMD_DISPATCH 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_SSSE3
+#    if LEXY_HAS_SIMD_DISPATCH || defined(__SSSE3__) || defined(__AVX__)
+#        define LEXY_HAS_SSSE3 1
+#    else
+#        define LEXY_HAS_SSSE3 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_AVX2
+#    if LEXY_HAS_SIMD_DISPATCH || defined(__AVX2__)
+#        define LEXY_HAS_AVX2 1
+#    else
+#        define LEXY_HAS_AVX2 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_AVX512
+#    if LEXY_HAS_SIMD_DISPATCH || defined(__AVX512BW__)
+#        define LEXY_HAS_AVX512 1
+#    else
+#        define LEXY_HAS_AVX512 0
+#    endif
+#endif
+
+//=== constant evaluation ===//
+#ifndef LEXY_HAS_CONSTANT_EVALUATED
+#    if defined(__has_builtin)
+#        if __has_builtin(__builtin_is_constant_evaluated)
+#            define LEXY_HAS_CONSTANT_EVALUATED 1
+#        endif
+#    endif
+#endif
+#ifndef LEXY_HAS_CONSTANT_EVALUATED
+#    if (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#        define LEXY_HAS_CONSTANT_EVALUATED 1
+#    else
+#        define LEXY_HAS_CONSTANT_EVALUATED 0
+#    endif
+#endif
+
+//=== engine counters ===//
+#ifndef LEXY_ENABLE_ENGINE_COUNTERS
+// Whether or not engines count how often they backtrack, see `lexy/engine/counters.hpp`.
+#    define LEXY_ENABLE_ENGINE_COUNTERS 0
+#endif
+
 //=== force inline ===//
 #ifndef LEXY_FORCE_INLINE
 #    if defined(__has_cpp_attribute)
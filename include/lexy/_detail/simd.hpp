@@ -0,0 +1,133 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_DETAIL_SIMD_HPP_INCLUDED
+#define LEXY_DETAIL_SIMD_HPP_INCLUDED
+
+#include <cstdint>
+#include <lexy/_detail/config.hpp>
+
+#if LEXY_HAS_SSSE3 || LEXY_HAS_AVX2 || LEXY_HAS_AVX512
+#    include <immintrin.h>
+#elif LEXY_HAS_SSE2
+#    include <emmintrin.h>
+#endif
+#if LEXY_HAS_SIMD_DISPATCH && defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+// Compiles a kernel for the instruction set, even if the compiler doesn't target it.
+// It must only be called if `host_simd_level()` says the CPU supports it.
+#if LEXY_HAS_SIMD_DISPATCH && (defined(__GNUC__) || defined(__clang__))
+#    define LEXY_SIMD_TARGET(Target) __attribute__((target(Target)))
+#else
+#    define LEXY_SIMD_TARGET(Target)
+#endif
+
+namespace lexy::_detail
+{
+enum class simd_level
+{
+    scalar,
+    sse2,
+    ssse3,
+    avx2,
+    /// AVX-512 with byte and word instructions (AVX-512BW).
+    avx512,
+};
+
+#if LEXY_HAS_SIMD_DISPATCH && defined(_MSC_VER)
+LEXY_SIMD_TARGET("xsave") inline std::uint64_t _read_xcr0() noexcept
+{
+    return _xgetbv(0);
+}
+#endif
+
+// Queries the instruction sets supported by the CPU and the operating system.
+inline simd_level detect_simd_level() noexcept
+{
+#if !LEXY_HAS_SIMD_DISPATCH
+    // We can only use the instruction sets the compiler targets.
+#    if defined(__AVX512BW__)
+    return simd_level::avx512;
+#    elif defined(__AVX2__)
+    return simd_level::avx2;
+#    elif defined(__SSSE3__) || defined(__AVX__)
+    return simd_level::ssse3;
+#    elif LEXY_HAS_SSE2
+    return simd_level::sse2;
+#    else
+    return simd_level::scalar;
+#    endif
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    auto max_leaf = info[0];
+
+    __cpuid(info, 1);
+    auto ssse3   = (info[2] & (1 << 9)) != 0;
+    auto osxsave = (info[2] & (1 << 27)) != 0;
+
+    auto avx2 = false, avx512bw = false;
+    if (max_leaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2     = (info[1] & (1 << 5)) != 0;
+        avx512bw = (info[1] & (1 << 30)) != 0;
+    }
+
+    // The operating system needs to save the AVX (and AVX-512) registers on context switches.
+    auto xcr0 = osxsave ? _read_xcr0() : 0;
+    if (avx512bw && (xcr0 & 0xE6) == 0xE6)
+        return simd_level::avx512;
+    else if (avx2 && (xcr0 & 0x06) == 0x06)
+        return simd_level::avx2;
+    else if (ssse3)
+        return simd_level::ssse3;
+    else
+        return simd_level::sse2;
+#else
+    // This also checks that the operating system supports the registers.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512bw"))
+        return simd_level::avx512;
+    else if (__builtin_cpu_supports("avx2"))
+        return simd_level::avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        return simd_level::ssse3;
+    else
+        return simd_level::sse2;
+#endif
+}
+
+/// The instruction sets the kernels can use on this CPU, which is detected the first time.
+/// Define `LEXY_FORCE_SIMD_LEVEL` to one of the enumerators to lower it, e.g. for testing.
+inline simd_level host_simd_level() noexcept
+{
+#if LEXY_HAS_SIMD_DISPATCH
+    static const auto level = detect_simd_level();
+#else
+    const auto level = detect_simd_level();
+#endif
+#if defined(LEXY_FORCE_SIMD_LEVEL)
+    // We can't force instruction sets the CPU doesn't support.
+    if (simd_level::LEXY_FORCE_SIMD_LEVEL < level)
+        return simd_level::LEXY_FORCE_SIMD_LEVEL;
+#endif
+    return level;
+}
+
+#if LEXY_HAS_AVX512
+LEXY_SIMD_TARGET("popcnt") inline unsigned popcount(std::uint64_t value) noexcept
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    return unsigned(__popcnt(unsigned(value)) + __popcnt(unsigned(value >> 32)));
+#    else
+    return unsigned(__builtin_popcountll(value));
+#    endif
+}
+#endif
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_SIMD_HPP_INCLUDED
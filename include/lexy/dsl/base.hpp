@@ -8,6 +8,7 @@
 #include <lexy/_detail/assert.hpp>
 #include <lexy/_detail/config.hpp>
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
 #include <lexy/error.hpp>
 #include <lexy/input/base.hpp>
 #include <lexy/result.hpp>
@@ -120,7 +121,9 @@ struct token_base : _token_base
 
         constexpr bool match(Reader& reader)
         {
-            return lexy::engine_try_match<typename Derived::token_engine>(reader);
+            using engine = lexy::_fused_engine<typename Derived::token_engine,
+                                               typename Reader::encoding>;
+            return lexy::engine_try_match<engine>(reader);
         }
 
         template <typename NextParser, typename Context, typename... Args>
@@ -139,9 +142,29 @@ struct token_base : _token_base
             typename Context::result_type
         {
             using token_engine = typename Derived::token_engine;
+            using fused_engine = lexy::_fused_engine<token_engine, typename Reader::encoding>;
             using continuation = lexy::whitespace_parser<Context, NextParser>;
 
-            if constexpr (lexy::engine_can_fail<token_engine, Reader>)
+            if constexpr (!lexy::engine_can_fail<token_engine, Reader>)
+            {
+                fused_engine::match(reader);
+                return continuation::parse(context, reader, LEXY_FWD(args)...);
+            }
+            else if constexpr (!std::is_same_v<fused_engine, token_engine>)
+            {
+                auto save     = reader;
+                auto position = reader.cur();
+                if (fused_engine::match(reader) == typename fused_engine::error_code())
+                    return continuation::parse(context, reader, LEXY_FWD(args)...);
+
+                // The DFA doesn't know the error, so we match again to report it.
+                reader  = LEXY_MOV(save);
+                auto ec = token_engine::match(reader);
+                LEXY_ASSERT(ec != typename token_engine::error_code(),
+                            "DFA and engine disagree on the match");
+                return Derived::token_error(context, reader, ec, position);
+            }
+            else
             {
                 auto position = reader.cur();
                 if (auto ec = token_engine::match(reader);
@@ -150,11 +173,6 @@ struct token_base : _token_base
                 else
                     return Derived::token_error(context, reader, ec, position);
             }
-            else
-            {
-                token_engine::match(reader);
-                return continuation::parse(context, reader, LEXY_FWD(args)...);
-            }
         }
     };
 
@@ -320,6 +338,15 @@ template <typename Production, typename Handler, typename Iterator>
 parse_context(Production p, Handler& handler, Iterator position)
     -> parse_context<Production, Handler, decltype(handler.start_production(p, position))>;
 
+/// Whether the handler ignores all values passed to `finish_production()` and its sinks.
+/// Rules can then skip producing the values, as long as they still detect the same errors.
+template <typename Handler>
+constexpr bool _handler_discards_values = false;
+
+template <typename Context>
+constexpr bool _context_discards_values
+    = _handler_discards_values<std::remove_reference_t<decltype(LEXY_DECLVAL(Context&).handler())>>;
+
 /// A final parser that forwards all elements to the context.
 struct context_value_parser
 {
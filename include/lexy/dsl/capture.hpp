@@ -18,10 +18,20 @@ struct _cap_cont
                              typename Reader::iterator begin, Args&&... args) ->
         typename Context::result_type
     {
-        auto end = reader.cur();
-        return NextParser::parse(context, reader, LEXY_FWD(prev_args)...,
-                                 Lexeme<typename Reader::canonical_reader>(begin, end),
-                                 LEXY_FWD(args)...);
+        using lexeme_t = Lexeme<typename Reader::canonical_reader>;
+        if constexpr (lexy::_context_discards_values<Context>
+                      && std::is_same_v<lexeme_t, lexy::lexeme<typename Reader::canonical_reader>>)
+        {
+            // Nobody is interested in the lexeme.
+            (void)begin;
+            return NextParser::parse(context, reader, LEXY_FWD(prev_args)..., LEXY_FWD(args)...);
+        }
+        else
+        {
+            auto end = reader.cur();
+            return NextParser::parse(context, reader, LEXY_FWD(prev_args)...,
+                                     lexeme_t(begin, end), LEXY_FWD(args)...);
+        }
     }
 };
 
@@ -34,23 +34,30 @@ struct _cp_cap : rule_base
         LEXY_DSL_FUNC auto parse(Context& context, Reader& reader, Args&&... args) ->
             typename Context::result_type
         {
-            auto save = reader;
-
-            lexy::engine_cp_auto::error_code ec{};
-            auto                             result = lexy::engine_cp_auto::parse(ec, reader);
-            if (ec == lexy::engine_cp_auto::error_code())
+            if constexpr (lexy::_context_discards_values<Context>)
             {
-                LEXY_PRECONDITION(result.is_scalar());
-                return NextParser::parse(context, reader, LEXY_FWD(args)..., result);
+                // We only need to check whether it is a code point.
+                if (lexy::engine_try_match<lexy::engine_cp_auto>(reader))
+                    return NextParser::parse(context, reader, LEXY_FWD(args)...);
             }
             else
             {
-                reader = LEXY_MOV(save);
+                auto save = reader;
+
+                lexy::engine_cp_auto::error_code ec{};
+                auto result = lexy::engine_cp_auto::parse(ec, reader);
+                if (ec == lexy::engine_cp_auto::error_code())
+                {
+                    LEXY_PRECONDITION(result.is_scalar());
+                    return NextParser::parse(context, reader, LEXY_FWD(args)..., result);
+                }
 
-                auto name = _cp_name<typename Reader::encoding>();
-                auto e    = lexy::make_error<Reader, lexy::expected_char_class>(reader.cur(), name);
-                return LEXY_MOV(context).error(e);
+                reader = LEXY_MOV(save);
             }
+
+            auto name = _cp_name<typename Reader::encoding>();
+            auto e    = lexy::make_error<Reader, lexy::expected_char_class>(reader.cur(), name);
+            return LEXY_MOV(context).error(e);
         }
     };
 };
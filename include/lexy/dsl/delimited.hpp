@@ -181,8 +181,11 @@ struct _escape_cap : branch_base
         template <typename NextParser, typename Context, typename... Args>
         constexpr auto parse(Context& context, Reader& reader, Args&&... args)
         {
-            return NextParser::parse(context, reader, LEXY_FWD(args)...,
-                                     lexy::lexeme(reader, _begin));
+            if constexpr (lexy::_context_discards_values<Context>)
+                return NextParser::parse(context, reader, LEXY_FWD(args)...);
+            else
+                return NextParser::parse(context, reader, LEXY_FWD(args)...,
+                                         lexy::lexeme(reader, _begin));
         }
     };
 };
@@ -58,7 +58,7 @@ struct _encoded_reader<Reader, lexy::utf16_encoding, Endianness>
 
     constexpr bool eof() const
     {
-        return peek() == eof();
+        return peek() == encoding::eof();
     }
 
     constexpr auto peek() const
@@ -102,7 +102,7 @@ struct _encoded_reader<Reader, lexy::utf32_encoding, Endianness>
 
     constexpr bool eof() const
     {
-        return peek() == eof();
+        return peek() == encoding::eof();
     }
 
     constexpr auto peek() const
@@ -155,6 +155,60 @@ struct _encoded_reader<Reader, lexy::utf32_encoding, Endianness>
     Reader& _reader;
 };
 
+// Multi-byte encodings of contiguous inputs.
+// Unlike `_encoded_reader`, it stores a position instead of a reference to the original reader, so
+// it can be copied and assigned when a rule backtracks.
+template <typename Reader, typename Encoding, lexy::encoding_endianness Endianness>
+struct _contiguous_encoded_reader
+{
+    static_assert(lexy::is_contiguous_reader<Reader>);
+
+    using encoding         = Encoding;
+    using char_type        = typename encoding::char_type;
+    using iterator         = typename Reader::iterator;
+    using canonical_reader = _contiguous_encoded_reader<Reader, Encoding, Endianness>;
+
+    constexpr explicit _contiguous_encoded_reader(Reader& reader) noexcept
+    : _reader(&reader), _cur(reader.cur()), _end(reader.end())
+    {}
+
+    constexpr bool eof() const
+    {
+        return std::size_t(_end - _cur) < sizeof(char_type);
+    }
+
+    constexpr auto peek() const
+    {
+        if (eof())
+            return encoding::eof();
+
+        // Compilers turn this into a single load, with a byte swap if necessary.
+        auto c = char_type(0);
+        for (auto idx = std::size_t(0); idx != sizeof(char_type); ++idx)
+        {
+            auto byte = static_cast<unsigned char>(_cur[idx]);
+            if constexpr (Endianness == lexy::encoding_endianness::little)
+                c = static_cast<char_type>(c | char_type(byte) << (8 * idx));
+            else
+                c = static_cast<char_type>(c << 8 | byte);
+        }
+        return encoding::to_int_type(c);
+    }
+
+    constexpr void bump()
+    {
+        _cur += sizeof(char_type);
+    }
+
+    constexpr iterator cur() const
+    {
+        return _cur;
+    }
+
+    Reader*  _reader;
+    iterator _cur, _end;
+};
+
 template <typename Encoding, lexy::encoding_endianness Endianness>
 struct _encode_begin : rule_base
 {
@@ -170,8 +224,18 @@ struct _encode_begin : rule_base
                               || (std::is_same_v<old_encoding, lexy::raw_encoding>),
                           "cannot re-encode input");
 
-            auto encoded_reader = _encoded_reader<Reader, Encoding, Endianness>{reader};
-            return NextParser::parse(context, encoded_reader, LEXY_FWD(args)...);
+            if constexpr (sizeof(typename Encoding::char_type) > 1
+                          && lexy::is_contiguous_reader<Reader>)
+            {
+                auto encoded_reader
+                    = _contiguous_encoded_reader<Reader, Encoding, Endianness>(reader);
+                return NextParser::parse(context, encoded_reader, LEXY_FWD(args)...);
+            }
+            else
+            {
+                auto encoded_reader = _encoded_reader<Reader, Encoding, Endianness>{reader};
+                return NextParser::parse(context, encoded_reader, LEXY_FWD(args)...);
+            }
         }
     };
 };
@@ -189,6 +253,17 @@ struct _encode_end : rule_base
         {
             return NextParser::parse(context, reader._reader, LEXY_FWD(args)...);
         }
+        template <typename Context, typename Reader, typename Encoding,
+                  lexy::encoding_endianness Endianness, typename... Args>
+        LEXY_DSL_FUNC auto parse(Context&                                                  context,
+                                 _contiguous_encoded_reader<Reader, Encoding, Endianness>& reader,
+                                 Args&&... args) -> typename Context::result_type
+        {
+            // We need to move the original reader to the current position.
+            auto& original = *reader._reader;
+            original.advance(std::size_t(reader.cur() - original.cur()));
+            return NextParser::parse(context, original, LEXY_FWD(args)...);
+        }
     };
 };
 
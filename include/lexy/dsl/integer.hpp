@@ -188,6 +188,13 @@ struct _unbounded_integer_parser
 
         return true;
     }
+
+    // Checks whether the digits can be parsed without computing the value.
+    template <typename Iterator>
+    static constexpr bool validate(Iterator, Iterator)
+    {
+        return true;
+    }
 };
 
 // Parses T in the Base without checking for overflow.
@@ -266,6 +273,30 @@ struct _bounded_integer_parser
         // Now we can only fail if there are still digits left.
         return cur == end;
     }
+
+    // Checks whether the digits can be parsed without computing the value.
+    template <typename Iterator>
+    static constexpr bool validate(Iterator cur, Iterator end)
+    {
+        constexpr auto max_digit_count = traits::template max_digit_count<radix>;
+
+        // We can only overflow if we have the maximal number of significant digits,
+        // only then do we need to compute the value.
+        auto digit_count = std::size_t(0);
+        for (auto iter = cur; iter != end; ++iter)
+        {
+            const auto digit = Base::value(*iter);
+            if (digit >= radix || (digit == 0 && digit_count == 0))
+                continue; // Digit separator or leading zero.
+
+            if (++digit_count == max_digit_count)
+            {
+                auto result = result_type(0);
+                return parse(result, cur, end);
+            }
+        }
+        return true;
+    }
 };
 
 // Continuation of integer that assumes the rule is already dealt with.
@@ -286,11 +317,20 @@ struct _int_p : rule_base
             using error_type
                 = lexy::error<typename Reader::canonical_reader, lexy::integer_overflow>;
 
-            auto result = typename integer_parser::result_type(0);
-            if (integer_parser::parse(result, begin, reader.cur()))
-                return NextParser::parse(context, reader, LEXY_FWD(args)..., result);
+            if constexpr (lexy::_context_discards_values<Context>)
+            {
+                // We only need to detect overflow.
+                if (integer_parser::validate(begin, reader.cur()))
+                    return NextParser::parse(context, reader, LEXY_FWD(args)...);
+            }
             else
-                return LEXY_MOV(context).error(error_type(begin, reader.cur()));
+            {
+                auto result = typename integer_parser::result_type(0);
+                if (integer_parser::parse(result, begin, reader.cur()))
+                    return NextParser::parse(context, reader, LEXY_FWD(args)..., result);
+            }
+
+            return LEXY_MOV(context).error(error_type(begin, reader.cur()));
         }
     };
 };
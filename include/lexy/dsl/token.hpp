@@ -6,6 +6,11 @@
 #define LEXY_DSL_TOKEN_HPP_INCLUDED
 
 #include <lexy/dsl/base.hpp>
+#include <lexy/dsl/branch.hpp>
+#include <lexy/dsl/option.hpp>
+#include <lexy/dsl/sequence.hpp>
+#include <lexy/dsl/while.hpp>
+#include <lexy/engine/while.hpp>
 #include <lexy/match.hpp>
 
 namespace lexy
@@ -25,27 +30,30 @@ struct _token_dummy_production
 {};
 
 template <typename Rule>
-struct _token : token_base<_token<Rule>>
+struct _token_engine : lexy::engine_matcher_base
 {
-    struct token_engine : lexy::engine_matcher_base
+    enum class error_code
     {
-        enum class error_code
-        {
-            error = 1,
-        };
-
-        template <typename Reader>
-        static constexpr error_code match(Reader& reader)
-        {
-            auto                handler = lexy::_match_handler{};
-            lexy::parse_context context(_token_dummy_production{}, handler, reader.cur());
-
-            return lexy::rule_parser<Rule, lexy::context_value_parser>::parse(context, reader)
-                       ? error_code()
-                       : error_code::error;
-        }
+        error = 1,
     };
 
+    template <typename Reader>
+    static constexpr error_code match(Reader& reader)
+    {
+        auto                handler = lexy::_match_handler{};
+        lexy::parse_context context(_token_dummy_production{}, handler, reader.cur());
+
+        return lexy::rule_parser<Rule, lexy::context_value_parser>::parse(context, reader)
+                   ? error_code()
+                   : error_code::error;
+    }
+};
+
+template <typename Rule>
+struct _token : token_base<_token<Rule>>
+{
+    using token_engine = _token_engine<Rule>;
+
     template <typename Context, typename Reader>
     static constexpr auto token_error(Context& context, const Reader&,
                                       typename token_engine::error_code,
@@ -73,5 +81,78 @@ LEXY_CONSTEVAL auto token(Rule)
 }
 } // namespace lexyd
 
+namespace lexyd
+{
+// The automaton of a rule that is composed of tokens, so the token can be matched as a DFA.
+// Arbitrary rules don't have one.
+template <typename Rule, typename Encoding, bool IsToken = lexy::is_token<Rule>>
+struct _regular_rule
+{
+    using type = lexy::_regular<Rule, Encoding>;
+};
+template <typename Token, typename Encoding>
+struct _regular_rule<Token, Encoding, true>
+{
+    using type = lexy::_regular<typename Token::token_engine, Encoding>;
+};
+
+template <typename Rule, typename Encoding>
+struct _regular_rule_part
+{
+    using type = lexy::_regular_part<typename _regular_rule<Rule, Encoding>::type, false>;
+};
+template <typename Branch, typename Encoding>
+struct _regular_rule_part<_opt<Branch>, Encoding>
+{
+    // Only a token can be skipped without having matched a part of the branch.
+    using _automaton = std::conditional_t<lexy::is_token<Branch>,
+                                          typename _regular_rule<Branch, Encoding>::type,
+                                          lexy::_regular<_opt<Branch>, Encoding>>;
+    using type       = lexy::_regular_part<_automaton, true>;
+};
+
+template <typename Branch, typename Encoding, bool IsToken = lexy::is_token<Branch>>
+struct _regular_rule_while
+{
+    using type = lexy::_regular<_whl<Branch>, Encoding>;
+};
+template <typename Token, typename Encoding>
+struct _regular_rule_while<Token, Encoding, true>
+{
+    using type = lexy::_regular<lexy::engine_while<typename Token::token_engine>, Encoding>;
+};
+
+template <typename... R, typename Encoding>
+struct _regular_rule<_seq<R...>, Encoding, false>
+{
+    using type = lexy::_regular_seq<typename _regular_rule_part<R, Encoding>::type...>;
+};
+template <typename Condition, typename... R, typename Encoding>
+struct _regular_rule<_br<Condition, R...>, Encoding, false>
+{
+    using type = lexy::_regular_seq<typename _regular_rule_part<Condition, Encoding>::type,
+                                    typename _regular_rule_part<R, Encoding>::type...>;
+};
+template <typename Branch, typename Encoding>
+struct _regular_rule<_opt<Branch>, Encoding, false>
+{
+    using type = lexy::_regular_seq<typename _regular_rule_part<_opt<Branch>, Encoding>::type>;
+};
+template <typename Branch, typename Encoding>
+struct _regular_rule<_whl<Branch>, Encoding, false> : _regular_rule_while<Branch, Encoding>
+{};
+} // namespace lexyd
+
+namespace lexy
+{
+template <typename Rule, typename Encoding>
+struct _regular<lexyd::_token_engine<Rule>, Encoding>
+: lexyd::_regular_rule<Rule, Encoding>::type
+{};
+
+template <typename Rule, typename Encoding>
+inline constexpr bool _engine_should_fuse<lexyd::_token_engine<Rule>, Encoding> = true;
+} // namespace lexy
+
 #endif // LEXY_DSL_TOKEN_HPP_INCLUDED
 
@@ -33,7 +33,8 @@ struct _wsr : rule_base
             if constexpr (lexy::is_token<Rule>)
             {
                 // Parsing a token repeatedly cannot fail, so we can optimize it using an engine.
-                using engine = lexy::engine_while<typename Rule::token_engine>;
+                using engine = lexy::_fused_engine<lexy::engine_while<typename Rule::token_engine>,
+                                                   typename Reader::encoding>;
                 engine::match(reader);
                 return NextParser::parse(context, reader, LEXY_FWD(args)...);
             }
@@ -6,9 +6,14 @@
 #define LEXY_ENGINE_BASE_HPP_INCLUDED
 
 #include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/code_unit_set.hpp>
 #include <lexy/_detail/config.hpp>
 #include <lexy/input/base.hpp>
 
+#if LEXY_ENABLE_ENGINE_COUNTERS
+#    include <lexy/engine/counters.hpp>
+#endif
+
 #if 0
 /// Matches something, i.e. consumes input and returns success or failure.
 struct Matcher : engine_matcher_base
@@ -60,6 +65,50 @@ constexpr bool engine_can_fail = true;
 /// Whether or not the engine can succeed on the given input.
 template <typename Engine, typename Reader>
 constexpr bool engine_can_succeed = true;
+
+/// The number of code units every match of the engine consumes, or `std::size_t(-1)` if it varies.
+template <typename Engine>
+constexpr auto engine_match_length = std::size_t(-1);
+
+/// The code units a non-empty match of the engine can begin with, if they are bytes.
+/// Input that begins with another code unit can be skipped without trying the engine.
+template <typename Engine, typename Encoding>
+constexpr auto engine_first_code_units = _detail::code_unit_set::all();
+
+// The first code units of an engine that matches a single code unit, found by trying all of them.
+template <typename Engine, typename Encoding>
+LEXY_CONSTEVAL auto _single_code_unit_set()
+{
+    using char_type = typename Encoding::char_type;
+    if constexpr (sizeof(char_type) != 1)
+        return _detail::code_unit_set::all();
+    else
+    {
+        _detail::code_unit_set result;
+        for (auto c = 0u; c != 0x100; ++c)
+        {
+            char_type str[]  = {static_cast<char_type>(c)};
+            auto      reader = _detail::range_reader<Encoding, const char_type*>(str, str + 1);
+            if (Engine::match(reader) == typename Engine::error_code())
+                result.insert(static_cast<unsigned char>(c));
+        }
+        return result;
+    }
+}
+
+// The first code units of an engine that begins with the character.
+template <typename Encoding, typename CharT>
+LEXY_CONSTEVAL auto _char_code_unit_set(CharT c)
+{
+    if constexpr (sizeof(typename Encoding::char_type) != 1)
+        return _detail::code_unit_set::all();
+    else
+    {
+        _detail::code_unit_set result;
+        result.insert(static_cast<unsigned char>(c));
+        return result;
+    }
+}
 } // namespace lexy
 
 namespace lexy
@@ -73,16 +122,31 @@ constexpr bool engine_try_match(Reader& reader)
     {
         auto save = reader;
         if (Matcher::match(reader) == typename Matcher::error_code())
+        {
+#if LEXY_ENABLE_ENGINE_COUNTERS
+            _detail::count_engine_try_match<Matcher>(save, reader, true);
+#endif
             return true;
+        }
         else
         {
+#if LEXY_ENABLE_ENGINE_COUNTERS
+            _detail::count_engine_try_match<Matcher>(save, reader, false);
+#endif
             reader = LEXY_MOV(save);
             return false;
         }
     }
     else
     {
+#if LEXY_ENABLE_ENGINE_COUNTERS
+        auto save   = reader;
+        auto result = Matcher::match(reader) == typename Matcher::error_code();
+        _detail::count_engine_try_match<Matcher>(save, reader, true);
+        return result;
+#else
         return Matcher::match(reader) == typename Matcher::error_code();
+#endif
     }
 }
 
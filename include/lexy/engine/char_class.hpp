@@ -8,6 +8,7 @@
 #include <climits>
 #include <lexy/_detail/integer_sequence.hpp>
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
 
 namespace lexy
 {
@@ -35,6 +36,18 @@ struct engine_char_range : engine_matcher_base
             return error_code::error;
     }
 };
+
+template <auto Min, auto Max, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_char_range<Min, Max>, Encoding>
+    = _single_code_unit_set<engine_char_range<Min, Max>, Encoding>();
+
+template <auto Min, auto Max>
+inline constexpr auto engine_match_length<engine_char_range<Min, Max>> = std::size_t(1);
+
+template <auto Min, auto Max, typename Encoding>
+struct _regular<engine_char_range<Min, Max>, Encoding>
+: _regular_code_unit<engine_char_range<Min, Max>, Encoding>
+{};
 } // namespace lexy
 
 namespace lexy
@@ -105,6 +118,17 @@ struct engine_char_set : engine_matcher_base
     }
 };
 
+template <const auto& STrie, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_char_set<STrie>, Encoding>
+    = _single_code_unit_set<engine_char_set<STrie>, Encoding>();
+
+template <const auto& STrie>
+inline constexpr auto engine_match_length<engine_char_set<STrie>> = std::size_t(1);
+
+template <const auto& STrie, typename Encoding>
+struct _regular<engine_char_set<STrie>, Encoding>
+: _regular_code_unit<engine_char_set<STrie>, Encoding>
+{};
 } // namespace lexy
 
 namespace lexy
@@ -199,6 +223,19 @@ struct engine_ascii_table : engine_matcher_base
         }
     }
 };
+
+template <const auto& Table, std::size_t... Categories, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_ascii_table<Table, Categories...>, Encoding>
+    = _single_code_unit_set<engine_ascii_table<Table, Categories...>, Encoding>();
+
+template <const auto& Table, std::size_t... Categories>
+inline constexpr auto engine_match_length<engine_ascii_table<Table, Categories...>>
+    = std::size_t(1);
+
+template <const auto& Table, std::size_t... Categories, typename Encoding>
+struct _regular<engine_ascii_table<Table, Categories...>, Encoding>
+: _regular_code_unit<engine_ascii_table<Table, Categories...>, Encoding>
+{};
 } // namespace lexy
 
 #endif // LEXY_ENGINE_CHAR_CLASS_HPP_INCLUDED
@@ -0,0 +1,135 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_ENGINE_COUNTERS_HPP_INCLUDED
+#define LEXY_ENGINE_COUNTERS_HPP_INCLUDED
+
+#include <atomic>
+#include <cstdio>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/type_name.hpp>
+#include <lexy/input/base.hpp>
+
+#if LEXY_ENABLE_ENGINE_COUNTERS && !defined(__GNUC__) && !defined(_MSC_VER)
+#    error "LEXY_ENABLE_ENGINE_COUNTERS requires __builtin_is_constant_evaluated()"
+#endif
+
+namespace lexy
+{
+/// Counts how often an engine backtracks.
+/// Only updated if `LEXY_ENABLE_ENGINE_COUNTERS` is enabled.
+struct engine_counter
+{
+    /// The type name of the engine.
+    _detail::string_view name;
+    /// The number of `engine_try_match()` calls of the engine.
+    std::atomic<std::size_t> attempts{0};
+    /// The number of `engine_try_match()` calls that failed and restored the reader.
+    std::atomic<std::size_t> failures{0};
+    /// The number of code units consumed by failed `engine_try_match()` calls,
+    /// that need to be read again.
+    std::atomic<std::size_t> wasted{0};
+    /// The number of failures of `engine_trie` and `engine_literal` after a partial match.
+    std::atomic<std::size_t> partial_failures{0};
+
+    engine_counter* next = nullptr;
+
+    explicit engine_counter(_detail::string_view name) noexcept : name(name)
+    {
+        // Register the counter, the registry is a lock-free singly-linked list.
+        auto& head = _head();
+        next       = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(next, this, std::memory_order_release,
+                                           std::memory_order_relaxed))
+        {}
+    }
+
+    engine_counter(const engine_counter&) = delete;
+    engine_counter& operator=(const engine_counter&) = delete;
+
+    static std::atomic<engine_counter*>& _head() noexcept
+    {
+        static std::atomic<engine_counter*> head{nullptr};
+        return head;
+    }
+};
+
+/// Invokes the function for the counter of each engine that has been used.
+template <typename Fn>
+void for_each_engine_counter(Fn fn)
+{
+    auto counter = engine_counter::_head().load(std::memory_order_acquire);
+    for (; counter != nullptr; counter = counter->next)
+        fn(static_cast<const engine_counter&>(*counter));
+}
+
+/// Sets all counters to zero.
+inline void reset_engine_counters()
+{
+    auto counter = engine_counter::_head().load(std::memory_order_acquire);
+    for (; counter != nullptr; counter = counter->next)
+    {
+        counter->attempts.store(0, std::memory_order_relaxed);
+        counter->failures.store(0, std::memory_order_relaxed);
+        counter->wasted.store(0, std::memory_order_relaxed);
+        counter->partial_failures.store(0, std::memory_order_relaxed);
+    }
+}
+
+/// Writes a line with the counters of each engine that has failed.
+inline void write_engine_counters(std::FILE* file)
+{
+    std::fputs("wasted failures attempts partial_failures engine\n", file);
+    for_each_engine_counter([&](const engine_counter& counter) {
+        auto failures         = counter.failures.load(std::memory_order_relaxed);
+        auto partial_failures = counter.partial_failures.load(std::memory_order_relaxed);
+        if (failures == 0 && partial_failures == 0)
+            return;
+
+        auto wasted   = counter.wasted.load(std::memory_order_relaxed);
+        auto attempts = counter.attempts.load(std::memory_order_relaxed);
+        std::fprintf(file, "%zu %zu %zu %zu %.*s\n", wasted, failures, attempts, partial_failures,
+                     int(counter.name.size()), counter.name.data());
+    });
+}
+} // namespace lexy
+
+namespace lexy::_detail
+{
+template <typename Engine>
+engine_counter& get_engine_counter()
+{
+    static engine_counter counter(_detail::type_name<Engine>(0));
+    return counter;
+}
+
+// Records an `engine_try_match()` with the reader before and after the match.
+template <typename Engine, typename Reader>
+constexpr void count_engine_try_match(const Reader& save, const Reader& reader, bool success)
+{
+    if (__builtin_is_constant_evaluated())
+        return;
+
+    auto& counter = get_engine_counter<Engine>();
+    counter.attempts.fetch_add(1, std::memory_order_relaxed);
+    if (!success)
+    {
+        counter.failures.fetch_add(1, std::memory_order_relaxed);
+        counter.wasted.fetch_add(_detail::range_size(save.cur(), reader.cur()),
+                                 std::memory_order_relaxed);
+    }
+}
+
+// Records a failure of the engine after it has consumed input.
+template <typename Engine>
+constexpr void count_engine_partial_failure()
+{
+    if (__builtin_is_constant_evaluated())
+        return;
+
+    get_engine_counter<Engine>().partial_failures.fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_ENGINE_COUNTERS_HPP_INCLUDED
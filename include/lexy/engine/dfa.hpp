@@ -0,0 +1,492 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_ENGINE_DFA_HPP_INCLUDED
+#define LEXY_ENGINE_DFA_HPP_INCLUDED
+
+#include <lexy/engine/base.hpp>
+
+//=== regular engines ===//
+namespace lexy
+{
+/// Describes an engine as an automaton over bytes, if it is regular.
+///
+/// The states are numbered from zero, the start state, to `state_count - 1`;
+/// `state_count` is the dead state, which only transitions to itself.
+/// A match ends at the last `end()` state that was reached;
+/// it is successful if that state is also an `accept()` state.
+/// Two bytes are `equivalent()` if every state has the same transition for them.
+///
+/// Specialized in the header of each engine that is regular.
+/// Only used if the code units of the encoding are bytes.
+template <typename Engine, typename Encoding>
+struct _regular
+{
+    static constexpr bool        value       = false;
+    static constexpr std::size_t state_count = 0;
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t, unsigned char)
+    {
+        return 0;
+    }
+    static LEXY_CONSTEVAL bool end(std::size_t)
+    {
+        return false;
+    }
+    static LEXY_CONSTEVAL bool accept(std::size_t)
+    {
+        return false;
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char, unsigned char)
+    {
+        return false;
+    }
+};
+
+// An engine that matches a single code unit of a set.
+template <typename Engine, typename Encoding>
+struct _regular_code_unit
+{
+    static constexpr auto _set = _single_code_unit_set<Engine, Encoding>();
+
+    static constexpr bool        value       = true;
+    static constexpr std::size_t state_count = 2;
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t state, unsigned char c)
+    {
+        return state == 0 && _set.contains(c) ? 1 : state_count;
+    }
+    static LEXY_CONSTEVAL bool end(std::size_t state)
+    {
+        return state == 1;
+    }
+    static LEXY_CONSTEVAL bool accept(std::size_t state)
+    {
+        return state == 1;
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char lhs, unsigned char rhs)
+    {
+        return _set.contains(lhs) == _set.contains(rhs);
+    }
+};
+
+// Whether the character of a literal or trie matches the byte.
+template <typename Encoding, typename CharT>
+LEXY_CONSTEVAL bool _regular_char_matches(CharT c, unsigned char byte)
+{
+    using char_type = typename Encoding::char_type;
+    return Encoding::to_int_type(static_cast<char_type>(byte)) == _char_to_int_type<Encoding>(c);
+}
+
+} // namespace lexy
+
+//=== dfa ===//
+namespace lexy
+{
+template <std::size_t StateCount, std::size_t ClassCount>
+struct _dfa
+{
+    static constexpr std::size_t dead = StateCount;
+
+    constexpr std::size_t next(std::size_t state, unsigned char c) const
+    {
+        return _next[state][_byte_class[c]];
+    }
+    constexpr bool end(std::size_t state) const
+    {
+        return (_flags[state] & 0b01) != 0;
+    }
+    constexpr bool accept(std::size_t state) const
+    {
+        return (_flags[state] & 0b10) != 0;
+    }
+
+    unsigned char _byte_class[0x100];
+    unsigned char _next[StateCount][ClassCount];
+    unsigned char _flags[StateCount];
+};
+
+// The maximal number of states of a DFA, so they fit in an unsigned char together with dead.
+constexpr std::size_t _dfa_max_states = 0xFF;
+
+// Partitions the bytes into classes of equivalent bytes.
+template <typename Regular>
+LEXY_CONSTEVAL auto _make_dfa_classes()
+{
+    struct result_t
+    {
+        std::size_t   count = 0;
+        unsigned char byte_class[0x100]     = {};
+        unsigned char representative[0x100] = {};
+    } result;
+
+    for (auto c = 0u; c != 0x100; ++c)
+    {
+        auto byte = static_cast<unsigned char>(c);
+
+        auto cls = std::size_t(0);
+        while (cls != result.count && !Regular::equivalent(result.representative[cls], byte))
+            ++cls;
+        if (cls == result.count)
+            result.representative[result.count++] = byte;
+
+        result.byte_class[c] = static_cast<unsigned char>(cls);
+    }
+
+    return result;
+}
+
+// Enumerates the reachable states of the automaton and their transitions.
+template <typename Regular, const auto& Classes>
+LEXY_CONSTEVAL auto _make_dfa_builder()
+{
+    struct builder_t
+    {
+        bool          overflow                             = false;
+        std::size_t   state_count                          = 1;
+        std::size_t   states[_dfa_max_states]              = {};
+        unsigned char next[_dfa_max_states][Classes.count] = {};
+        unsigned char flags[_dfa_max_states]               = {};
+    } builder;
+
+    // The states array is also the queue of states whose transitions we still need to compute.
+    for (auto idx = std::size_t(0); idx != builder.state_count; ++idx)
+    {
+        auto state         = builder.states[idx];
+        builder.flags[idx] = static_cast<unsigned char>((Regular::end(state) ? 0b01 : 0)
+                                                        | (Regular::accept(state) ? 0b10 : 0));
+
+        for (auto cls = std::size_t(0); cls != Classes.count; ++cls)
+        {
+            auto target = Regular::next(state, Classes.representative[cls]);
+            if (target == Regular::state_count)
+            {
+                builder.next[idx][cls] = _dfa_max_states;
+                continue;
+            }
+
+            auto target_idx = std::size_t(0);
+            while (target_idx != builder.state_count && builder.states[target_idx] != target)
+                ++target_idx;
+            if (target_idx == builder.state_count)
+            {
+                if (builder.state_count == _dfa_max_states)
+                {
+                    builder.overflow = true;
+                    return builder;
+                }
+                builder.states[builder.state_count++] = target;
+            }
+
+            builder.next[idx][cls] = static_cast<unsigned char>(target_idx);
+        }
+    }
+
+    return builder;
+}
+
+template <typename Regular>
+constexpr auto _regular_classes = _make_dfa_classes<Regular>();
+template <typename Regular>
+constexpr auto _regular_builder = _make_dfa_builder<Regular, _regular_classes<Regular>>();
+
+template <typename Engine, typename Encoding>
+constexpr auto& _dfa_classes = _regular_classes<_regular<Engine, Encoding>>;
+template <typename Engine, typename Encoding>
+constexpr auto& _dfa_builder = _regular_builder<_regular<Engine, Encoding>>;
+
+template <typename Engine, typename Encoding>
+LEXY_CONSTEVAL auto _make_dfa()
+{
+    constexpr auto& classes = _dfa_classes<Engine, Encoding>;
+    constexpr auto& builder = _dfa_builder<Engine, Encoding>;
+
+    _dfa<builder.state_count, classes.count> result{};
+    for (auto c = 0u; c != 0x100; ++c)
+        result._byte_class[c] = classes.byte_class[c];
+    for (auto state = std::size_t(0); state != builder.state_count; ++state)
+    {
+        for (auto cls = std::size_t(0); cls != classes.count; ++cls)
+        {
+            auto target              = builder.next[state][cls];
+            result._next[state][cls] = static_cast<unsigned char>(
+                target == _dfa_max_states ? result.dead : std::size_t(target));
+        }
+        result._flags[state] = builder.flags[state];
+    }
+    return result;
+}
+
+/// A DFA that matches the same input as the regular engine, with bytes as code units.
+template <typename Engine, typename Encoding>
+constexpr auto dfa = _make_dfa<Engine, Encoding>();
+
+/// Whether the engine is regular and can be turned into a `dfa`.
+template <typename Engine, typename Encoding>
+constexpr bool engine_is_regular = [] {
+    if constexpr (sizeof(typename Encoding::char_type) != 1)
+        return false;
+    else if constexpr (!_regular<Engine, Encoding>::value)
+        return false;
+    else
+        return !_dfa_builder<Engine, Encoding>.overflow;
+}();
+
+// Whether the engine can be repeated by going back to the start instead of its end states:
+// this requires that matching stops in an end state, which must be accepting.
+template <typename Engine, typename Encoding>
+LEXY_CONSTEVAL bool _regular_is_repeatable()
+{
+    if constexpr (!engine_is_regular<Engine, Encoding>)
+        return false;
+    else
+    {
+        constexpr auto& classes = _dfa_classes<Engine, Encoding>;
+        constexpr auto& builder = _dfa_builder<Engine, Encoding>;
+        if (builder.flags[0] != 0)
+            return false;
+
+        for (auto state = std::size_t(0); state != builder.state_count; ++state)
+        {
+            if (builder.flags[state] == 0)
+                continue;
+            else if (builder.flags[state] != 0b11)
+                return false;
+
+            for (auto cls = std::size_t(0); cls != classes.count; ++cls)
+                if (builder.next[state][cls] != _dfa_max_states)
+                    return false;
+        }
+
+        return true;
+    }
+}
+
+// Whether the automaton can be matched as part of a sequence without backtracking:
+// once it reaches an end state, which must be accepting, it only reaches end states.
+// If it is optional, every state it reaches from the start must be an end state.
+template <typename Regular, bool Optional>
+LEXY_CONSTEVAL bool _regular_is_sequenceable()
+{
+    if constexpr (!Regular::value)
+        return false;
+    else
+    {
+        constexpr auto& classes = _regular_classes<Regular>;
+        constexpr auto& builder = _regular_builder<Regular>;
+        if (builder.overflow)
+            return false;
+
+        for (auto state = std::size_t(0); state != builder.state_count; ++state)
+        {
+            if (builder.flags[state] == 0)
+            {
+                if (Optional && state != 0)
+                    return false;
+                continue;
+            }
+            else if (builder.flags[state] != 0b11)
+                return false;
+
+            for (auto cls = std::size_t(0); cls != classes.count; ++cls)
+            {
+                auto target = builder.next[state][cls];
+                if (target != _dfa_max_states && builder.flags[target] != 0b11)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+// A part of a `_regular_seq`.
+template <typename Regular, bool Optional>
+struct _regular_part
+{
+    static constexpr bool        value       = _regular_is_sequenceable<Regular, Optional>();
+    static constexpr std::size_t state_count = Regular::state_count;
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t state, unsigned char c)
+    {
+        return Regular::next(state, c);
+    }
+    // Whether we can continue with the next part.
+    static LEXY_CONSTEVAL bool done(std::size_t state)
+    {
+        return Regular::end(state) || (Optional && state == 0);
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char lhs, unsigned char rhs)
+    {
+        return Regular::equivalent(lhs, rhs);
+    }
+};
+
+// Matches each part as long as possible, then the next one.
+template <typename... Parts>
+struct _regular_seq
+{
+    static_assert(sizeof...(Parts) > 0);
+
+    // The state is the state of the current part, offset by the states of the previous parts.
+    static constexpr std::size_t _size[] = {Parts::state_count...};
+
+    static LEXY_CONSTEVAL std::size_t _offset(std::size_t part)
+    {
+        auto result = std::size_t(0);
+        for (auto i = std::size_t(0); i != part; ++i)
+            result += _size[i];
+        return result;
+    }
+    static LEXY_CONSTEVAL std::size_t _part(std::size_t state)
+    {
+        auto part = std::size_t(0);
+        while (state >= _offset(part + 1))
+            ++part;
+        return part;
+    }
+
+    static LEXY_CONSTEVAL std::size_t _next(std::size_t part, std::size_t state, unsigned char c)
+    {
+        auto idx    = std::size_t(0);
+        auto result = std::size_t(0);
+        ((result = idx++ == part ? Parts::next(state, c) : result), ...);
+        return result;
+    }
+    static LEXY_CONSTEVAL bool _done(std::size_t part, std::size_t state)
+    {
+        auto idx    = std::size_t(0);
+        auto result = false;
+        ((result = idx++ == part ? Parts::done(state) : result), ...);
+        return result;
+    }
+
+    static constexpr bool        value       = (Parts::value && ...);
+    static constexpr std::size_t state_count = (std::size_t(0) + ... + Parts::state_count);
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t state, unsigned char c)
+    {
+        if (state == state_count)
+            return state_count;
+
+        auto part = _part(state);
+        state -= _offset(part);
+        while (true)
+        {
+            auto result = _next(part, state, c);
+            if (result != _size[part])
+                return _offset(part) + result;
+
+            // The part can't continue, so the byte has to be matched by the next one.
+            if (part + 1 == sizeof...(Parts) || !_done(part, state))
+                return state_count;
+            ++part;
+            state = 0;
+        }
+    }
+    static LEXY_CONSTEVAL bool end(std::size_t state)
+    {
+        if (state == state_count)
+            return false;
+
+        auto part = _part(state);
+        if (!_done(part, state - _offset(part)))
+            return false;
+
+        // All remaining parts need to match the empty string.
+        for (++part; part != sizeof...(Parts); ++part)
+            if (!_done(part, 0))
+                return false;
+        return true;
+    }
+    static LEXY_CONSTEVAL bool accept(std::size_t state)
+    {
+        return end(state);
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char lhs, unsigned char rhs)
+    {
+        return (Parts::equivalent(lhs, rhs) && ...);
+    }
+};
+
+/// Matches the DFA: it consumes input as long as possible and then backtracks to the last end
+/// state.
+template <const auto& Dfa>
+struct engine_dfa : engine_matcher_base
+{
+    enum class error_code
+    {
+        error = 1,
+    };
+
+    template <typename Reader>
+    static constexpr error_code match(Reader& reader)
+    {
+        using char_type = typename Reader::encoding::char_type;
+        static_assert(sizeof(char_type) == 1);
+
+        auto state  = std::size_t(0);
+        auto found  = Dfa.end(state);
+        auto accept = Dfa.accept(state);
+        auto last   = reader;
+        while (!reader.eof())
+        {
+            state = Dfa.next(state, static_cast<unsigned char>(*reader.cur()));
+            if (state == Dfa.dead)
+                break;
+
+            reader.bump();
+            if (Dfa.end(state))
+            {
+                found  = true;
+                accept = Dfa.accept(state);
+                last   = reader;
+            }
+        }
+
+        if (!found || !accept)
+            return error_code::error;
+
+        // Go back to the last end state.
+        reader = LEXY_MOV(last);
+        return error_code();
+    }
+};
+} // namespace lexy
+
+//=== fusion ===//
+namespace lexy
+{
+/// Whether an engine composed of other engines should be matched as a DFA.
+/// Specialized in the header of each such engine.
+template <typename Engine, typename Encoding>
+constexpr bool _engine_should_fuse = false;
+
+template <typename Engine, typename Encoding>
+constexpr bool _engine_fuse = [] {
+    if constexpr (_engine_should_fuse<Engine, Encoding>)
+        return engine_is_regular<Engine, Encoding>;
+    else
+        return false;
+}();
+
+template <bool Fuse, typename Engine, typename Encoding>
+struct _fused_engine_impl
+{
+    using type = Engine;
+};
+template <typename Engine, typename Encoding>
+struct _fused_engine_impl<true, Engine, Encoding>
+{
+    using type = engine_dfa<dfa<Engine, Encoding>>;
+};
+
+/// The DFA of the engine if it is composed of regular engines, the engine itself otherwise.
+/// Only use it if the error code doesn't matter.
+template <typename Engine, typename Encoding>
+using _fused_engine =
+    typename _fused_engine_impl<_engine_fuse<Engine, Encoding>, Engine, Encoding>::type;
+} // namespace lexy
+
+#endif // LEXY_ENGINE_DFA_HPP_INCLUDED
@@ -6,6 +6,8 @@
 #define LEXY_ENGINE_DIGITS_HPP_INCLUDED
 
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
+#include <lexy/engine/while.hpp>
 
 namespace lexy
 {
@@ -63,6 +65,19 @@ struct engine_digits_sep : engine_matcher_base
         return error_code();
     }
 };
+
+template <typename DigitSet, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_digits<DigitSet>, Encoding>
+    = engine_first_code_units<DigitSet, Encoding>;
+template <typename DigitSet, typename Sep, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_digits_sep<DigitSet, Sep>, Encoding>
+    = engine_first_code_units<DigitSet, Encoding>;
+
+template <typename DigitSet, typename Encoding>
+struct _regular<engine_digits<DigitSet>, Encoding>
+: _regular_seq<_regular_part<_regular<DigitSet, Encoding>, false>,
+               _regular_part<_regular<engine_while<DigitSet>, Encoding>, false>>
+{};
 } // namespace lexy
 
 namespace lexy
@@ -163,6 +178,22 @@ struct engine_digits_trimmed_sep : engine_matcher_base
         }
     }
 };
+
+template <typename DigitSet, typename Zero, typename Encoding>
+LEXY_CONSTEVAL auto _digits_trimmed_code_unit_set()
+{
+    auto result = engine_first_code_units<DigitSet, Encoding>;
+    result.insert(engine_first_code_units<Zero, Encoding>);
+    return result;
+}
+
+template <typename DigitSet, typename Zero, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_digits_trimmed<DigitSet, Zero>, Encoding>
+    = _digits_trimmed_code_unit_set<DigitSet, Zero, Encoding>();
+template <typename DigitSet, typename Zero, typename Sep, typename Encoding>
+inline constexpr auto
+    engine_first_code_units<engine_digits_trimmed_sep<DigitSet, Zero, Sep>, Encoding>
+    = _digits_trimmed_code_unit_set<DigitSet, Zero, Encoding>();
 } // namespace lexy
 
 namespace lexy
@@ -211,6 +242,10 @@ struct engine_ndigits : engine_matcher_base
     }
 };
 
+template <std::size_t N, typename DigitSet, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_ndigits<N, DigitSet>, Encoding>
+    = engine_first_code_units<DigitSet, Encoding>;
+
 /// Matches exactly N digits optionally separated.
 template <std::size_t N, typename DigitSet, typename Sep>
 struct engine_ndigits_sep : engine_matcher_base
@@ -263,6 +298,10 @@ struct engine_ndigits_sep : engine_matcher_base
         return error_code();
     }
 };
+
+template <std::size_t N, typename DigitSet, typename Sep, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_ndigits_sep<N, DigitSet, Sep>, Encoding>
+    = engine_first_code_units<DigitSet, Encoding>;
 } // namespace lexy
 
 #endif // LEXY_ENGINE_DIGITS_HPP_INCLUDED
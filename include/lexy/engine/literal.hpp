@@ -7,6 +7,7 @@
 
 #include <lexy/_detail/integer_sequence.hpp>
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
 
 namespace lexy
 {
@@ -17,6 +18,10 @@ struct _ltrie
     {
         return NodeCount == 0;
     }
+    LEXY_CONSTEVAL std::size_t size() const
+    {
+        return NodeCount;
+    }
 
     LEXY_CONSTEVAL auto node_sequence() const
     {
@@ -84,12 +89,63 @@ struct engine_literal : engine_matcher_base
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
+#if LEXY_ENABLE_ENGINE_COUNTERS
+        auto result = _transition(reader, LTrie.node_sequence());
+        if (result != error_code() && index_from_error(result) > 0)
+            _detail::count_engine_partial_failure<engine_literal>();
+        return result;
+#else
         return _transition(reader, LTrie.node_sequence());
+#endif
     }
 };
 
 template <const auto& LTrie, typename Reader>
 inline constexpr bool engine_can_fail<engine_literal<LTrie>, Reader> = !LTrie.empty();
+
+template <const auto& LTrie>
+inline constexpr auto engine_match_length<engine_literal<LTrie>> = LTrie.size();
+
+template <const auto& LTrie, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_literal<LTrie>, Encoding> = [] {
+    if constexpr (LTrie.empty())
+        return _detail::code_unit_set();
+    else
+        return _char_code_unit_set<Encoding>(LTrie._transition[0]);
+}();
+
+template <const auto& LTrie, typename Encoding>
+struct _regular<engine_literal<LTrie>, Encoding>
+{
+    // State `i` has matched the first `i` characters.
+    static constexpr bool        value       = true;
+    static constexpr std::size_t state_count = LTrie.size() + 1;
+
+    static LEXY_CONSTEVAL bool _matches(std::size_t state, unsigned char c)
+    {
+        return state < LTrie.size() && _regular_char_matches<Encoding>(LTrie._transition[state], c);
+    }
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t state, unsigned char c)
+    {
+        return _matches(state, c) ? state + 1 : state_count;
+    }
+    static LEXY_CONSTEVAL bool end(std::size_t state)
+    {
+        return state == LTrie.size();
+    }
+    static LEXY_CONSTEVAL bool accept(std::size_t state)
+    {
+        return state == LTrie.size();
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char lhs, unsigned char rhs)
+    {
+        for (auto state = std::size_t(0); state != LTrie.size(); ++state)
+            if (_matches(state, lhs) != _matches(state, rhs))
+                return false;
+        return true;
+    }
+};
 } // namespace lexy
 
 #endif // LEXY_ENGINE_LITERAL_HPP_INCLUDED
@@ -5,10 +5,15 @@
 #ifndef LEXY_ENGINE_MINUS_HPP_INCLUDED
 #define LEXY_ENGINE_MINUS_HPP_INCLUDED
 
+#include <lexy/_detail/detect.hpp>
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
 
 namespace lexy
 {
+template <typename Iterator>
+using _detect_iterator_difference = decltype(LEXY_DECLVAL(Iterator) - LEXY_DECLVAL(Iterator));
+
 /// Matches `Matcher` but only if none of the `Excepts` match the same input.
 template <typename Matcher, typename... Excepts>
 struct engine_minus : lexy::engine_matcher_base
@@ -31,6 +36,33 @@ struct engine_minus : lexy::engine_matcher_base
         return typename Matcher::error_code(int(ec) - 1);
     }
 
+    // Whether the except matches exactly the input between `begin` and `end`.
+    template <typename Except, typename Reader>
+    static constexpr bool _except_matches(const Reader& begin, typename Reader::iterator end)
+    {
+        using encoding = typename Reader::encoding;
+        using iterator = typename Reader::iterator;
+
+        // Most of the time, we can rule out a match without reading the input again.
+        if (begin.cur() != end)
+        {
+            // A non-empty match has to begin with one of the first code units.
+            constexpr const auto& first = engine_first_code_units<Except, encoding>;
+            if constexpr (sizeof(typename encoding::char_type) == 1 && first.size() != 0x100)
+                if (!first.contains(static_cast<unsigned char>(*begin.cur())))
+                    return false;
+
+            // And it has to have the same length, if that is fixed and cheap to compute.
+            if constexpr (engine_match_length<Except> != std::size_t(-1)
+                          && _detail::is_detected<_detect_iterator_difference, iterator>)
+                if (std::size_t(end - begin.cur()) != engine_match_length<Except>)
+                    return false;
+        }
+
+        auto partial = lexy::partial_reader(begin, end);
+        return lexy::engine_try_match<Except>(partial) && partial.eof();
+    }
+
     template <typename Reader>
     static constexpr error_code match(Reader& reader)
     {
@@ -41,8 +73,7 @@ struct engine_minus : lexy::engine_matcher_base
             return error_from_matcher(ec);
 
         // Then check whether any of the Excepts match on the same input.
-        auto partial      = lexy::partial_reader(save, reader.cur());
-        auto except_match = ((lexy::engine_try_match<Excepts>(partial) && partial.eof()) || ...);
+        auto except_match = (_except_matches<Excepts>(save, reader.cur()) || ...);
         if (except_match)
             // They did, so we don't match.
             return error_code::minus_failure;
@@ -50,6 +81,87 @@ struct engine_minus : lexy::engine_matcher_base
         return error_code();
     }
 };
+
+template <typename Matcher, typename... Excepts, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_minus<Matcher, Excepts...>, Encoding>
+    = engine_first_code_units<Matcher, Encoding>;
+
+template <typename Matcher, typename... Excepts, typename Encoding>
+struct _regular<engine_minus<Matcher, Excepts...>, Encoding>
+{
+    using _matcher = _regular<Matcher, Encoding>;
+
+    // We run all automata in parallel, the state is the combination of their states.
+    // It is a mixed radix number where each automaton is a digit, which can also be its dead state.
+    static constexpr std::size_t _radix[]
+        = {_matcher::state_count + 1, (_regular<Excepts, Encoding>::state_count + 1)...};
+
+    static LEXY_CONSTEVAL std::size_t _digit(std::size_t state, std::size_t idx)
+    {
+        for (auto i = std::size_t(0); i != idx; ++i)
+            state /= _radix[i];
+        return state % _radix[idx];
+    }
+
+    template <typename Regular>
+    static LEXY_CONSTEVAL bool _matches(std::size_t state)
+    {
+        return Regular::end(state) && Regular::accept(state);
+    }
+
+    static constexpr bool value
+        = (_matcher::value && ... && _regular<Excepts, Encoding>::value);
+    static constexpr std::size_t state_count = [] {
+        auto result = std::size_t(1);
+        for (auto radix : _radix)
+            result *= radix;
+        return result;
+    }();
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t state, unsigned char c)
+    {
+        if (state == state_count)
+            return state_count;
+
+        // We only need to continue as long as the matcher can.
+        auto matcher = _matcher::next(_digit(state, 0), c);
+        if (matcher == _matcher::state_count)
+            return state_count;
+
+        auto result = matcher;
+        auto idx    = std::size_t(0);
+        auto factor = _radix[0];
+        ((++idx, result += factor * _regular<Excepts, Encoding>::next(_digit(state, idx), c),
+          factor *= _radix[idx]),
+         ...);
+        return result;
+    }
+    static LEXY_CONSTEVAL bool end(std::size_t state)
+    {
+        return state != state_count && _matcher::end(_digit(state, 0));
+    }
+    static LEXY_CONSTEVAL bool accept(std::size_t state)
+    {
+        if (!end(state) || !_matcher::accept(_digit(state, 0)))
+            return false;
+
+        // We don't accept if one of the excepts matches the same input.
+        auto idx          = std::size_t(0);
+        auto except_match = false;
+        ((++idx,
+          except_match = except_match || _matches<_regular<Excepts, Encoding>>(_digit(state, idx))),
+         ...);
+        return !except_match;
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char lhs, unsigned char rhs)
+    {
+        return (_matcher::equivalent(lhs, rhs) && ...
+                && _regular<Excepts, Encoding>::equivalent(lhs, rhs));
+    }
+};
+
+template <typename Matcher, typename... Excepts, typename Encoding>
+inline constexpr bool _engine_should_fuse<engine_minus<Matcher, Excepts...>, Encoding> = true;
 } // namespace lexy
 
 #endif // LEXY_ENGINE_MINUS_HPP_INCLUDED
@@ -7,12 +7,18 @@
 
 #include <lexy/_detail/integer_sequence.hpp>
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
 
 namespace lexy
 {
 template <typename CharT, std::size_t NodeCount, std::size_t TransitionCount>
 struct _trie
 {
+    LEXY_CONSTEVAL std::size_t node_count() const
+    {
+        return NodeCount;
+    }
+
     LEXY_CONSTEVAL bool node_accept(std::size_t node) const
     {
         return _node_accept[node];
@@ -198,7 +204,63 @@ struct engine_trie : engine_matcher_base
     static constexpr error_code match(Reader& reader)
     {
         // We begin in the root node of the trie.
+#if LEXY_ENABLE_ENGINE_COUNTERS
+        auto begin  = reader.cur();
+        auto result = _node<0, void>::match(reader);
+        if (result != error_code() && reader.cur() != begin)
+            _detail::count_engine_partial_failure<engine_trie>();
+        return result;
+#else
         return _node<0, void>::match(reader);
+#endif
+    }
+};
+
+template <const auto& Trie, typename Encoding>
+LEXY_CONSTEVAL auto _trie_code_unit_set()
+{
+    // A non-empty match begins with one of the transitions of the root node.
+    _detail::code_unit_set result;
+    for (auto transition = 0u; transition != Trie.transition_count(0); ++transition)
+        result.insert(_char_code_unit_set<Encoding>(Trie.transition_char(0, transition)));
+    return result;
+}
+
+template <const auto& Trie, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_trie<Trie>, Encoding>
+    = _trie_code_unit_set<Trie, Encoding>();
+
+template <const auto& Trie, typename Encoding>
+struct _regular<engine_trie<Trie>, Encoding>
+{
+    // The states are the nodes of the trie.
+    static constexpr bool        value       = true;
+    static constexpr std::size_t state_count = Trie.node_count();
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t state, unsigned char c)
+    {
+        if (state == state_count)
+            return state_count;
+
+        for (auto transition = 0u; transition != Trie.transition_count(state); ++transition)
+            if (_regular_char_matches<Encoding>(Trie.transition_char(state, transition), c))
+                return Trie.transition_next(state, transition);
+        return state_count;
+    }
+    static LEXY_CONSTEVAL bool end(std::size_t state)
+    {
+        return state != state_count && Trie.node_accept(state);
+    }
+    static LEXY_CONSTEVAL bool accept(std::size_t state)
+    {
+        return end(state);
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char lhs, unsigned char rhs)
+    {
+        for (auto state = std::size_t(0); state != state_count; ++state)
+            if (next(state, lhs) != next(state, rhs))
+                return false;
+        return true;
     }
 };
 } // namespace lexy
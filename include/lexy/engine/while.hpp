@@ -6,6 +6,7 @@
 #define LEXY_ENGINE_WHILE_HPP_INCLUDED
 
 #include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
 
 namespace lexy
 {
@@ -31,6 +32,41 @@ struct engine_while : engine_matcher_base
 
 template <typename Matcher, typename Reader>
 inline constexpr bool engine_can_fail<engine_while<Matcher>, Reader> = false;
+
+template <typename Matcher, typename Encoding>
+inline constexpr auto engine_first_code_units<engine_while<Matcher>, Encoding>
+    = engine_first_code_units<Matcher, Encoding>;
+
+template <typename Matcher, typename Encoding>
+struct _regular<engine_while<Matcher>, Encoding>
+{
+    using _matcher = _regular<Matcher, Encoding>;
+
+    // We use the states of the matcher, but go back to the start instead of its end states.
+    static constexpr bool        value       = _regular_is_repeatable<Matcher, Encoding>();
+    static constexpr std::size_t state_count = _matcher::state_count;
+
+    static LEXY_CONSTEVAL std::size_t next(std::size_t state, unsigned char c)
+    {
+        auto result = _matcher::next(state, c);
+        return _matcher::end(result) ? 0 : result;
+    }
+    static LEXY_CONSTEVAL bool end(std::size_t state)
+    {
+        return state == 0;
+    }
+    static LEXY_CONSTEVAL bool accept(std::size_t state)
+    {
+        return state == 0;
+    }
+    static LEXY_CONSTEVAL bool equivalent(unsigned char lhs, unsigned char rhs)
+    {
+        return _matcher::equivalent(lhs, rhs);
+    }
+};
+
+template <typename Matcher, typename Encoding>
+inline constexpr bool _engine_should_fuse<engine_while<Matcher>, Encoding> = true;
 } // namespace lexy
 
 #endif // LEXY_ENGINE_WHILE_HPP_INCLUDED
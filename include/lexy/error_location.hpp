@@ -5,7 +5,12 @@
 #ifndef LEXY_ERROR_LOCATION_HPP_INCLUDED
 #define LEXY_ERROR_LOCATION_HPP_INCLUDED
 
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/dsl/ascii.hpp>
 #include <lexy/dsl/base.hpp>
+#include <lexy/dsl/newline.hpp>
+#include <lexy/engine/code_point.hpp>
+#include <lexy/find.hpp>
 #include <lexy/input/base.hpp>
 #include <lexy/lexeme.hpp>
 
@@ -22,6 +27,107 @@ struct error_location
 template <typename Input>
 using error_location_for = error_location<input_reader<Input>>;
 
+enum class _location_counting
+{
+    none,
+    ascii, // newline is `dsl::newline`, columns are ASCII characters
+    utf8,  // newline is `dsl::newline`, columns are UTF-8 code points
+};
+
+// Whether we can compute the location by counting code units instead of matching the tokens.
+template <typename Input, typename TokenCP, typename TokenNL>
+constexpr auto _location_counting_for = [] {
+    using encoding  = typename input_reader<Input>::encoding;
+    using engine_cp = typename TokenCP::token_engine;
+    using engine_nl = typename TokenNL::token_engine;
+
+    if constexpr (!_is_byte_array_input<Input>
+                  || !std::is_same_v<engine_nl, typename dsl::_nl::token_engine>)
+        return _location_counting::none;
+    else if constexpr (std::is_same_v<engine_cp, typename dsl::ascii::_char::token_engine>
+                       || std::is_same_v<engine_cp, engine_cp_ascii>
+                       || (std::is_same_v<engine_cp, engine_cp_auto>
+                           && std::is_same_v<encoding, ascii_encoding>))
+        return _location_counting::ascii;
+    else if constexpr ((std::is_same_v<engine_cp, engine_cp_utf8>
+                        || std::is_same_v<engine_cp, engine_cp_auto>)
+                       && std::is_same_v<encoding, utf8_encoding>)
+        return _location_counting::utf8;
+    else
+        return _location_counting::none;
+}();
+
+struct _location_columns
+{
+    std::size_t          column;
+    const unsigned char* line_end;
+};
+
+// Counts the code points like the tokens do: ill-formed code units aren't columns.
+inline std::size_t _count_utf8_columns(const unsigned char* cur, const unsigned char* end)
+{
+    using iterator = const LEXY_CHAR8_T*;
+    auto reader    = _detail::range_reader<utf8_encoding, iterator>(reinterpret_cast<iterator>(cur),
+                                                                 reinterpret_cast<iterator>(end));
+
+    auto result = std::size_t(0);
+    while (reader.cur() < reinterpret_cast<iterator>(end))
+    {
+        if (lexy::engine_try_match<engine_cp_utf8>(reader))
+            ++result;
+        else
+            reader.bump();
+    }
+    return result;
+}
+
+// Counts the columns of the line up to the position and finds the end of the line.
+template <_location_counting Counting>
+_location_columns _count_location_columns(const unsigned char* line_start,
+                                          const unsigned char* pos, const unsigned char* end)
+{
+    auto column = std::size_t(1);
+    auto ascii  = _detail::count_ascii(line_start, pos);
+    if (Counting == _location_counting::ascii || ascii == std::size_t(pos - line_start))
+        column += ascii;
+    else
+        // Only a UTF-8 validator could tell whether we can count lead bytes instead.
+        column += _count_utf8_columns(line_start, pos);
+
+    // The line ends at the next \n, or at the \r of a \r\n.
+    auto line_end = static_cast<const unsigned char*>(
+        std::memchr(pos, '\n', std::size_t(end - pos)));
+    if (line_end == nullptr)
+        line_end = end;
+    else if (line_end != pos && line_end[-1] == '\r')
+        --line_end;
+
+    return {column, line_end};
+}
+
+template <_location_counting Counting, typename Input>
+auto _make_error_location_counting(const Input& input, typename input_reader<Input>::iterator pos)
+    -> error_location_for<Input>
+{
+    using iterator = typename input_reader<Input>::iterator;
+    auto begin     = reinterpret_cast<const unsigned char*>(input.reader().cur());
+    auto end       = reinterpret_cast<const unsigned char*>(input.reader().end());
+
+    // An out of bounds position is treated like the end of the input.
+    auto cur = reinterpret_cast<const unsigned char*>(pos);
+    if (cur > end)
+        cur = end;
+
+    auto line       = 1 + _detail::count_code_unit(begin, cur, '\n');
+    auto last_nl    = _detail::find_last_code_unit(begin, cur, '\n');
+    auto line_start = last_nl == cur ? begin : last_nl + 1;
+
+    auto [column, line_end] = _count_location_columns<Counting>(line_start, cur, end);
+    return {line, column,
+            lexeme_for<Input>(reinterpret_cast<iterator>(line_start),
+                              reinterpret_cast<iterator>(line_end))};
+}
+
 template <typename Input, typename TokenCP, typename TokenNL>
 constexpr auto make_error_location(const Input& input, typename input_reader<Input>::iterator pos,
                                    TokenCP, TokenNL) -> error_location_for<Input>
@@ -30,6 +136,16 @@ constexpr auto make_error_location(const Input& input, typename input_reader<Inp
     using engine_cp = typename TokenCP::token_engine;
     using engine_nl = typename TokenNL::token_engine;
 
+    constexpr auto counting = _location_counting_for<Input, TokenCP, TokenNL>;
+    if constexpr (counting != _location_counting::none)
+    {
+#if LEXY_HAS_CONSTANT_EVALUATED
+        // For the common tokens, we can count code units with SIMD instead.
+        if (!__builtin_is_constant_evaluated())
+            return _make_error_location_counting<counting>(input, pos);
+#endif
+    }
+
     auto reader = input.reader();
 
     // We start at the first line and first column.
@@ -87,5 +203,152 @@ constexpr auto make_error_location(const Input& input, typename input_reader<Inp
 }
 } // namespace lexy
 
+namespace lexy
+{
+/// Computes error locations like `make_error_location()`, but only scans the input once.
+/// The start of each line is found the first time it is needed, a location then only requires a
+/// binary search for the line and a walk from the start of the line to the position.
+template <typename Input, typename TokenCP, typename TokenNL,
+          typename MemoryResource = _detail::default_memory_resource>
+class line_index
+{
+    static_assert(is_token<TokenCP> && is_token<TokenNL>);
+    using _engine_cp = typename TokenCP::token_engine;
+    using _engine_nl = typename TokenNL::token_engine;
+
+    using _encoding = typename input_reader<Input>::encoding;
+    using _iterator = typename input_reader<Input>::iterator;
+    static_assert(is_contiguous_reader<input_reader<Input>>,
+                  "line_index requires an input stored in memory");
+
+public:
+    //=== constructors ===//
+    /// The input must outlive the index.
+    explicit line_index(const Input& input, TokenCP = {}, TokenNL = {})
+    : line_index(input, _detail::get_memory_resource<MemoryResource>())
+    {}
+    explicit line_index(const Input& input, MemoryResource* resource)
+    : _input(&input), _resource(resource), _line_starts(nullptr), _size(0), _capacity(0)
+    {}
+
+    line_index(const line_index&) = delete;
+    line_index& operator=(const line_index&) = delete;
+
+    ~line_index() noexcept
+    {
+        if (_line_starts)
+            _resource->deallocate(_line_starts, _capacity * sizeof(_iterator), alignof(_iterator));
+    }
+
+    //=== access ===//
+    /// The number of lines of the input.
+    std::size_t line_count()
+    {
+        _build();
+        return _size;
+    }
+
+    /// The location of the position, which must be in the input.
+    error_location_for<Input> location(_iterator pos)
+    {
+        _build();
+
+        // Find the last line that starts at or before the position.
+        auto begin = std::size_t(0);
+        auto end   = _size;
+        while (end - begin > 1)
+        {
+            auto middle = begin + (end - begin) / 2;
+            if (_line_starts[middle] <= pos)
+                begin = middle;
+            else
+                end = middle;
+        }
+        auto line_start = _line_starts[begin];
+
+        constexpr auto counting = _location_counting_for<Input, TokenCP, TokenNL>;
+        if constexpr (counting != _location_counting::none)
+        {
+            // For the common tokens, we can count code units with SIMD instead.
+            auto start = reinterpret_cast<const unsigned char*>(line_start);
+            auto cur   = reinterpret_cast<const unsigned char*>(pos);
+            auto end   = reinterpret_cast<const unsigned char*>(_input_end());
+
+            auto [column, line_end] = _count_location_columns<counting>(start, cur, end);
+            auto context = lexeme_for<Input>(line_start, reinterpret_cast<_iterator>(line_end));
+            return error_location_for<Input>{begin + 1, column, context};
+        }
+
+        // Count the columns in the line.
+        auto reader = _detail::range_reader<_encoding, _iterator>(line_start, _input_end());
+        auto column = std::size_t(1);
+        while (reader.cur() < pos)
+        {
+            if (!lexy::engine_try_match<_engine_cp>(reader))
+                // Invalid code unit, just ignore it in the column count.
+                reader.bump();
+            else
+                ++column;
+        }
+
+        // Find the end of the line for the context.
+        while (!reader.eof() && !lexy::engine_peek<_engine_nl>(reader))
+            reader.bump();
+
+        using lexeme_type = lexeme<input_reader<Input>>;
+        return error_location_for<Input>{begin + 1, column, lexeme_type(line_start, reader.cur())};
+    }
+
+private:
+    _iterator _input_end() const
+    {
+        return _input->reader().end();
+    }
+
+    void _push_back(_iterator line_start)
+    {
+        if (_size == _capacity)
+        {
+            auto capacity = _capacity == 0 ? std::size_t(64) : 2 * _capacity;
+            auto memory   = static_cast<_iterator*>(
+                _resource->allocate(capacity * sizeof(_iterator), alignof(_iterator)));
+            if (_line_starts)
+            {
+                for (auto i = std::size_t(0); i != _size; ++i)
+                    memory[i] = _line_starts[i];
+                _resource->deallocate(_line_starts, _capacity * sizeof(_iterator),
+                                      alignof(_iterator));
+            }
+
+            _line_starts = memory;
+            _capacity    = capacity;
+        }
+
+        _line_starts[_size++] = line_start;
+    }
+
+    void _build()
+    {
+        if (_size > 0)
+            return;
+
+        // A line starts at the beginning and after every newline.
+        // We assume that a newline can't begin inside a code point.
+        _push_back(_input->reader().cur());
+        auto scanner = _scanner<_engine_nl, Input>(*_input);
+        for (auto newline = scanner.next(); !newline.empty(); newline = scanner.next())
+            _push_back(newline.end());
+    }
+
+    const Input*                                                   _input;
+    LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
+    _iterator*                                                     _line_starts;
+    std::size_t                                                    _size, _capacity;
+};
+
+template <typename Input, typename TokenCP, typename TokenNL>
+line_index(const Input&, TokenCP, TokenNL) -> line_index<Input, TokenCP, TokenNL>;
+} // namespace lexy
+
 #endif // LEXY_ERROR_LOCATION_HPP_INCLUDED
 
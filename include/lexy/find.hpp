@@ -0,0 +1,598 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_FIND_HPP_INCLUDED
+#define LEXY_FIND_HPP_INCLUDED
+
+#include <cstring>
+#include <iterator>
+#include <lexy/_detail/code_unit_set.hpp>
+#include <lexy/_detail/detect.hpp>
+#include <lexy/_detail/integer_sequence.hpp>
+#include <lexy/_detail/simd.hpp>
+#include <lexy/dsl/base.hpp>
+#include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
+#include <lexy/input/base.hpp>
+#include <lexy/lexeme.hpp>
+
+#if LEXY_HAS_SSE2 && defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+//=== prefilter ===//
+namespace lexy::_detail
+{
+#if LEXY_HAS_SSE2
+inline unsigned count_trailing_zeros(unsigned value) noexcept
+{
+    LEXY_PRECONDITION(value != 0);
+#    if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long result;
+    _BitScanForward(&result, value);
+    return unsigned(result);
+#    else
+    return unsigned(__builtin_ctz(value));
+#    endif
+}
+
+inline unsigned highest_set_bit(unsigned value) noexcept
+{
+    LEXY_PRECONDITION(value != 0);
+#    if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long result;
+    _BitScanReverse(&result, value);
+    return unsigned(result);
+#    else
+    return unsigned(31 - __builtin_clz(value));
+#    endif
+}
+
+// Returns a mask of the bytes in [Min, Max].
+template <unsigned char Min, unsigned char Max>
+__m128i sse2_in_range(__m128i data) noexcept
+{
+    if constexpr (Min == Max)
+        return _mm_cmpeq_epi8(data, _mm_set1_epi8(char(Min)));
+    else
+    {
+        // data - Min <= Max - Min, as unsigned comparison, i.e. min(data - Min, Max - Min) == data.
+        auto offset = _mm_sub_epi8(data, _mm_set1_epi8(char(Min)));
+        return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(char(Max - Min))), offset);
+    }
+}
+
+template <const code_unit_set& Set, std::size_t... Ranges>
+__m128i sse2_in_set(__m128i data, index_sequence<Ranges...>) noexcept
+{
+    auto result = _mm_setzero_si128();
+    ((result = _mm_or_si128(result,
+                            sse2_in_range<Set.range_min(Ranges), Set.range_max(Ranges)>(data))),
+     ...);
+    return result;
+}
+#endif
+
+#if LEXY_HAS_SSE2
+// Searches in blocks of 16 bytes and returns the first code unit in the set, or nullptr.
+// Advances `cur` past the blocks that were searched.
+template <const code_unit_set& Set, std::size_t Padding>
+const unsigned char* sse2_find_code_unit(const unsigned char*& cur,
+                                         const unsigned char* end) noexcept
+{
+    using ranges = make_index_sequence<Set.range_count()>;
+    // With enough padding, we can load the last block even if it extends past the end.
+    auto ptr = cur;
+    for (; Padding >= 15 ? ptr < end : end - ptr >= 16; ptr += 16)
+    {
+        auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        auto mask = unsigned(_mm_movemask_epi8(sse2_in_set<Set>(data, ranges{})));
+        if (mask != 0)
+        {
+            auto pos = ptr + count_trailing_zeros(mask);
+            return pos < end ? pos : end;
+        }
+    }
+
+    cur = ptr < end ? ptr : end;
+    return nullptr;
+}
+#endif
+
+#if LEXY_HAS_AVX2
+template <unsigned char Min, unsigned char Max>
+LEXY_SIMD_TARGET("avx2")
+__m256i avx2_in_range(__m256i data) noexcept
+{
+    if constexpr (Min == Max)
+        return _mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(Min)));
+    else
+    {
+        auto offset = _mm256_sub_epi8(data, _mm256_set1_epi8(char(Min)));
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(char(Max - Min))),
+                                 offset);
+    }
+}
+
+template <const code_unit_set& Set, std::size_t... Ranges>
+LEXY_SIMD_TARGET("avx2")
+__m256i avx2_in_set(__m256i data, index_sequence<Ranges...>) noexcept
+{
+    auto result = _mm256_setzero_si256();
+    ((result = _mm256_or_si256(result,
+                               avx2_in_range<Set.range_min(Ranges), Set.range_max(Ranges)>(data))),
+     ...);
+    return result;
+}
+
+// Same as `sse2_find_code_unit()`, but in blocks of 32 bytes.
+template <const code_unit_set& Set, std::size_t Padding>
+LEXY_SIMD_TARGET("avx2")
+const unsigned char* avx2_find_code_unit(const unsigned char*& cur,
+                                         const unsigned char* end) noexcept
+{
+    using ranges = make_index_sequence<Set.range_count()>;
+    auto ptr = cur;
+    for (; Padding >= 31 ? ptr < end : end - ptr >= 32; ptr += 32)
+    {
+        auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        auto mask = unsigned(_mm256_movemask_epi8(avx2_in_set<Set>(data, ranges{})));
+        if (mask != 0)
+        {
+            auto pos = ptr + count_trailing_zeros(mask);
+            return pos < end ? pos : end;
+        }
+    }
+
+    cur = ptr < end ? ptr : end;
+    return nullptr;
+}
+#endif
+
+/// Returns a pointer to the first code unit in [cur, end) that is in the set, or end.
+/// If `Padding` bytes after end can be read, the tail doesn't need to be handled separately.
+template <const code_unit_set& Set, std::size_t Padding = 0>
+const unsigned char* find_code_unit(const unsigned char* cur, const unsigned char* end) noexcept
+{
+    if constexpr (Set.size() == 0)
+        return end;
+    else if constexpr (Set.size() == 0x100)
+        return cur;
+    else if constexpr (Set.size() == 1)
+    {
+        // The standard library has a vectorized search for a single byte.
+        auto ptr = std::memchr(cur, Set.range_min(0), std::size_t(end - cur));
+        return ptr ? static_cast<const unsigned char*>(ptr) : end;
+    }
+    else
+    {
+#if LEXY_HAS_SSE2
+        // We compare a block of bytes at a time against each range of the set.
+        // With too many ranges, the table lookup below is faster.
+        if constexpr (Set.range_count() <= 8)
+        {
+            const auto level = host_simd_level();
+#    if LEXY_HAS_AVX2
+            if (level >= simd_level::avx2)
+                if (auto pos = avx2_find_code_unit<Set, Padding>(cur, end))
+                    return pos;
+#    endif
+            if (level >= simd_level::sse2)
+                if (auto pos = sse2_find_code_unit<Set, Padding>(cur, end))
+                    return pos;
+        }
+#endif
+
+        while (cur != end && !Set.contains(*cur))
+            ++cur;
+        return cur;
+    }
+}
+
+/// Returns a pointer to the last code unit in [cur, end) that is equal to `c`, or end.
+inline const unsigned char* find_last_code_unit(const unsigned char* cur, const unsigned char* end,
+                                                unsigned char c) noexcept
+{
+    auto ptr = end;
+#if LEXY_HAS_SSE2
+    if (host_simd_level() >= simd_level::sse2)
+    {
+        for (; ptr - cur >= 16; ptr -= 16)
+        {
+            auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr - 16));
+            auto mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(c)))));
+            if (mask != 0)
+                return ptr - 16 + highest_set_bit(mask);
+        }
+    }
+#endif
+
+    while (ptr != cur)
+    {
+        --ptr;
+        if (*ptr == c)
+            return ptr;
+    }
+    return end;
+}
+} // namespace lexy::_detail
+
+//=== counting ===//
+namespace lexy::_detail
+{
+// The predicates for the counting kernels: they return a mask of the bytes that are counted.
+struct _count_code_unit
+{
+    unsigned char c;
+
+    bool scalar(unsigned char byte) const noexcept
+    {
+        return byte == c;
+    }
+#if LEXY_HAS_SSE2
+    __m128i sse2(__m128i data) const noexcept
+    {
+        return _mm_cmpeq_epi8(data, _mm_set1_epi8(char(c)));
+    }
+#endif
+#if LEXY_HAS_AVX2
+    LEXY_SIMD_TARGET("avx2") __m256i avx2(__m256i data) const noexcept
+    {
+        return _mm256_cmpeq_epi8(data, _mm256_set1_epi8(char(c)));
+    }
+#endif
+#if LEXY_HAS_AVX512
+    LEXY_SIMD_TARGET("avx512bw") __mmask64 avx512(__m512i data) const noexcept
+    {
+        return _mm512_cmpeq_epi8_mask(data, _mm512_set1_epi8(char(c)));
+    }
+#endif
+};
+
+// As signed integers, ASCII characters are not negative.
+struct _count_ascii
+{
+    bool scalar(unsigned char byte) const noexcept
+    {
+        return byte <= 0x7F;
+    }
+#if LEXY_HAS_SSE2
+    __m128i sse2(__m128i data) const noexcept
+    {
+        return _mm_cmpgt_epi8(data, _mm_set1_epi8(-1));
+    }
+#endif
+#if LEXY_HAS_AVX2
+    LEXY_SIMD_TARGET("avx2") __m256i avx2(__m256i data) const noexcept
+    {
+        return _mm256_cmpgt_epi8(data, _mm256_set1_epi8(-1));
+    }
+#endif
+#if LEXY_HAS_AVX512
+    LEXY_SIMD_TARGET("avx512bw") __mmask64 avx512(__m512i data) const noexcept
+    {
+        return _mm512_cmpgt_epi8_mask(data, _mm512_set1_epi8(-1));
+    }
+#endif
+};
+
+// As signed integers, continuation bytes 0b10xx'xxxx are the values [-128, -65].
+struct _count_utf8_code_point
+{
+    bool scalar(unsigned char byte) const noexcept
+    {
+        return (byte & 0b1100'0000) != 0b1000'0000;
+    }
+#if LEXY_HAS_SSE2
+    __m128i sse2(__m128i data) const noexcept
+    {
+        return _mm_cmpgt_epi8(data, _mm_set1_epi8(-65));
+    }
+#endif
+#if LEXY_HAS_AVX2
+    LEXY_SIMD_TARGET("avx2") __m256i avx2(__m256i data) const noexcept
+    {
+        return _mm256_cmpgt_epi8(data, _mm256_set1_epi8(-65));
+    }
+#endif
+#if LEXY_HAS_AVX512
+    LEXY_SIMD_TARGET("avx512bw") __mmask64 avx512(__m512i data) const noexcept
+    {
+        return _mm512_cmpgt_epi8_mask(data, _mm512_set1_epi8(-65));
+    }
+#endif
+};
+
+#if LEXY_HAS_SSE2
+// Counts the bytes where the predicate returns a mask of all ones, in blocks of 16 bytes.
+// Advances `cur` to the remaining bytes.
+template <typename Predicate>
+std::size_t sse2_count(const unsigned char*& cur, const unsigned char* end, Predicate pred) noexcept
+{
+    auto result = std::size_t(0);
+    while (end - cur >= 16)
+    {
+        // Each byte of the accumulator counts up to 255 matches before we need to sum them up.
+        auto acc = _mm_setzero_si128();
+        for (auto i = 0; i != 255 && end - cur >= 16; ++i, cur += 16)
+        {
+            auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+            acc       = _mm_sub_epi8(acc, pred.sse2(data));
+        }
+
+        auto sum = _mm_sad_epu8(acc, _mm_setzero_si128());
+        result += std::size_t(_mm_cvtsi128_si32(sum)) + std::size_t(_mm_extract_epi16(sum, 4));
+    }
+    return result;
+}
+#endif
+
+#if LEXY_HAS_AVX2
+// Same as `sse2_count()`, but in blocks of 32 bytes.
+template <typename Predicate>
+LEXY_SIMD_TARGET("avx2")
+std::size_t avx2_count(const unsigned char*& cur, const unsigned char* end, Predicate pred) noexcept
+{
+    auto result = std::size_t(0);
+    while (end - cur >= 32)
+    {
+        auto acc = _mm256_setzero_si256();
+        for (auto i = 0; i != 255 && end - cur >= 32; ++i, cur += 32)
+        {
+            auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur));
+            acc       = _mm256_sub_epi8(acc, pred.avx2(data));
+        }
+
+        auto sum256 = _mm256_sad_epu8(acc, _mm256_setzero_si256());
+        auto sum    = _mm_add_epi64(_mm256_castsi256_si128(sum256),
+                                 _mm256_extracti128_si256(sum256, 1));
+        result += std::size_t(_mm_cvtsi128_si32(sum)) + std::size_t(_mm_extract_epi16(sum, 4));
+    }
+    return result;
+}
+#endif
+
+#if LEXY_HAS_AVX512
+// Counts the bytes where the predicate returns a set bit, in blocks of 64 bytes.
+template <typename Predicate>
+LEXY_SIMD_TARGET("avx512bw,popcnt")
+std::size_t avx512_count(const unsigned char*& cur, const unsigned char* end,
+                         Predicate pred) noexcept
+{
+    auto result = std::size_t(0);
+    for (; end - cur >= 64; cur += 64)
+    {
+        auto data = _mm512_loadu_si512(reinterpret_cast<const void*>(cur));
+        result += popcount(pred.avx512(data));
+    }
+    return result;
+}
+#endif
+
+template <typename Predicate>
+std::size_t _count(const unsigned char* cur, const unsigned char* end, Predicate pred) noexcept
+{
+    auto result = std::size_t(0);
+
+    // Each kernel counts as many blocks as it can, the next one continues with the rest.
+    [[maybe_unused]] const auto level = host_simd_level();
+#if LEXY_HAS_AVX512
+    if (level >= simd_level::avx512)
+        result += avx512_count(cur, end, pred);
+#endif
+#if LEXY_HAS_AVX2
+    if (level >= simd_level::avx2)
+        result += avx2_count(cur, end, pred);
+#endif
+#if LEXY_HAS_SSE2
+    if (level >= simd_level::sse2)
+        result += sse2_count(cur, end, pred);
+#endif
+
+    for (; cur != end; ++cur)
+        if (pred.scalar(*cur))
+            ++result;
+    return result;
+}
+
+/// Returns the number of code units in [cur, end) that are equal to `c`.
+inline std::size_t count_code_unit(const unsigned char* cur, const unsigned char* end,
+                                   unsigned char c) noexcept
+{
+    return _count(cur, end, _count_code_unit{c});
+}
+
+/// Returns the number of ASCII characters in [cur, end).
+inline std::size_t count_ascii(const unsigned char* cur, const unsigned char* end) noexcept
+{
+    return _count(cur, end, _count_ascii{});
+}
+
+/// Returns the number of UTF-8 code points in [cur, end), i.e. the bytes that aren't continuation
+/// bytes. This is only exact for well-formed UTF-8.
+inline std::size_t count_utf8_code_points(const unsigned char* cur,
+                                          const unsigned char* end) noexcept
+{
+    return _count(cur, end, _count_utf8_code_point{});
+}
+} // namespace lexy::_detail
+
+//=== scanner ===//
+namespace lexy
+{
+// Whether the input is an array of bytes we can search directly.
+template <typename Input>
+constexpr bool _is_byte_array_input = is_contiguous_reader<input_reader<Input>>
+                                      && sizeof(typename input_reader<Input>::char_type) == 1;
+
+// Finds the matches of the engine from left to right.
+template <typename Engine, typename Input>
+class _scanner
+{
+    using _reader_type = input_reader<Input>;
+    using _encoding    = typename _reader_type::encoding;
+    using _char_type   = typename _reader_type::char_type;
+
+public:
+    using lexeme_type = lexeme_for<Input>;
+
+    explicit _scanner(const Input& input) : _reader(input.reader()) {}
+
+    /// Returns the next non-empty match, or an empty lexeme if there is none.
+    lexeme_type next()
+    {
+        while (true)
+        {
+            _skip();
+            if (_reader.eof())
+                return {};
+
+            auto begin = _reader.cur();
+            if (lexy::engine_try_match<_fused_engine<Engine, _encoding>>(_reader)
+                && _reader.cur() != begin)
+                return lexeme_type(begin, _reader.cur());
+
+            // The reader is still at the beginning, try the next position.
+            _reader.bump();
+        }
+    }
+
+private:
+    // Advances the reader to the next position where a match can begin.
+    void _skip()
+    {
+        constexpr const auto& first = engine_first_code_units<Engine, _encoding>;
+        if constexpr (sizeof(_char_type) != 1 || first.size() == 0x100)
+            return;
+        else if constexpr (is_contiguous_reader<_reader_type>)
+        {
+            auto cur = reinterpret_cast<const unsigned char*>(_reader.cur());
+            auto end = reinterpret_cast<const unsigned char*>(_reader.end());
+            auto pos = _detail::find_code_unit<first, reader_padding<_reader_type>>(cur, end);
+            _reader.advance(std::size_t(pos - cur));
+        }
+        else
+        {
+            while (!_reader.eof()
+                   && !first.contains(
+                       static_cast<unsigned char>(static_cast<_char_type>(_reader.peek()))))
+                _reader.bump();
+        }
+    }
+
+    _reader_type _reader;
+};
+} // namespace lexy
+
+//=== find_all ===//
+namespace lexy
+{
+/// Calls `callback` with the lexeme of each match of the token and returns the number of matches.
+/// The matches are found from left to right and don't overlap; empty matches are ignored.
+template <typename Input, typename Token, typename Callback>
+std::size_t scan(const Input& input, Token, Callback callback)
+{
+    static_assert(lexy::is_token<Token>, "scan() requires a token");
+
+    auto scanner = _scanner<typename Token::token_engine, Input>(input);
+    auto count   = std::size_t(0);
+    for (auto lexeme = scanner.next(); !lexeme.empty(); lexeme = scanner.next())
+    {
+        callback(lexeme);
+        ++count;
+    }
+    return count;
+}
+
+/// A range of the lexemes of the matches of a token, see `find_all()`.
+template <typename Token, typename Input>
+class find_all_range
+{
+    using _scanner_type = _scanner<typename Token::token_engine, Input>;
+
+public:
+    using lexeme_type = typename _scanner_type::lexeme_type;
+
+    class sentinel
+    {};
+
+    class iterator
+    {
+    public:
+        using value_type        = lexeme_type;
+        using reference         = const lexeme_type&;
+        using pointer           = const lexeme_type*;
+        using difference_type   = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        reference operator*() const noexcept
+        {
+            return _cur;
+        }
+        pointer operator->() const noexcept
+        {
+            return &_cur;
+        }
+
+        iterator& operator++()
+        {
+            _cur = _impl.next();
+            return *this;
+        }
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator& iter, sentinel) noexcept
+        {
+            return iter._cur.empty();
+        }
+        friend bool operator!=(const iterator& iter, sentinel) noexcept
+        {
+            return !iter._cur.empty();
+        }
+        friend bool operator==(sentinel, const iterator& iter) noexcept
+        {
+            return iter._cur.empty();
+        }
+        friend bool operator!=(sentinel, const iterator& iter) noexcept
+        {
+            return !iter._cur.empty();
+        }
+
+    private:
+        explicit iterator(const _scanner_type& scanner) : _impl(scanner), _cur(_impl.next()) {}
+
+        _scanner_type _impl;
+        lexeme_type   _cur;
+
+        friend find_all_range;
+    };
+
+    explicit find_all_range(const Input& input) : _impl(input) {}
+
+    iterator begin() const
+    {
+        return iterator(_impl);
+    }
+    sentinel end() const noexcept
+    {
+        return {};
+    }
+
+private:
+    _scanner_type _impl;
+};
+
+/// Returns a range of the lexemes of each match of the token in the input, see `scan()`.
+template <typename Input, typename Token>
+find_all_range<Token, Input> find_all(const Input& input, Token)
+{
+    static_assert(lexy::is_token<Token>, "find_all() requires a token");
+    return find_all_range<Token, Input>(input);
+}
+} // namespace lexy
+
+#endif // LEXY_FIND_HPP_INCLUDED
@@ -6,6 +6,7 @@
 #define LEXY_INPUT_BASE_HPP_INCLUDED
 
 #include <lexy/_detail/config.hpp>
+#include <lexy/_detail/detect.hpp>
 #include <lexy/encoding.hpp>
 
 #if 0
@@ -45,6 +46,28 @@ public:
     iterator cur() const;
 };
 
+/// Optionally, a Reader whose iterator is a pointer into a contiguous array can be a
+/// ContiguousReader. Engines can detect that using `lexy::is_contiguous_reader` and work on the
+/// remaining characters directly instead of bumping one at a time.
+class ContiguousReader : public Reader
+{
+public:
+    using iterator = const char_type*;
+
+    /// Returns a pointer one past the last character of the input.
+    iterator end() const;
+
+    /// Returns the number of characters until the end, i.e. `end() - cur()`.
+    std::size_t remaining() const;
+
+    /// Advances by the given number of characters, which must be at most `remaining()`.
+    void advance(std::size_t n);
+
+    /// Optional: the number of bytes after `end()` that can be read, e.g. by SIMD loads.
+    /// Query it using `lexy::reader_padding`.
+    static constexpr std::size_t padding;
+};
+
 /// An Input produces a reader.
 class Input
 {
@@ -70,6 +93,10 @@ constexpr auto range_size(I begin, I2 end)
     return result;
 }
 
+// Whether a range_reader is a ContiguousReader.
+template <typename Iterator, typename Sentinel>
+constexpr bool _is_contiguous = std::is_pointer_v<Iterator> && std::is_same_v<Iterator, Sentinel>;
+
 template <typename Encoding, typename Iterator, typename Sentinel = Iterator>
 class range_reader
 {
@@ -105,6 +132,23 @@ public:
         return _cur;
     }
 
+    //=== contiguous reader ===//
+    template <typename S = Sentinel, typename = std::enable_if_t<_is_contiguous<Iterator, S>>>
+    constexpr iterator end() const noexcept
+    {
+        return _end;
+    }
+    template <typename S = Sentinel, typename = std::enable_if_t<_is_contiguous<Iterator, S>>>
+    constexpr std::size_t remaining() const noexcept
+    {
+        return std::size_t(_end - _cur);
+    }
+    template <typename S = Sentinel, typename = std::enable_if_t<_is_contiguous<Iterator, S>>>
+    constexpr void advance(std::size_t n) noexcept
+    {
+        _cur += n;
+    }
+
     constexpr void _make_eof() noexcept
     {
         static_assert(std::is_same_v<Iterator, Sentinel>);
@@ -130,6 +174,34 @@ constexpr bool char_type_compatible_with_reader
 template <typename Reader>
 constexpr bool is_canonical_reader = std::is_same_v<typename Reader::canonical_reader, Reader>;
 
+template <typename Reader>
+using _detect_contiguous_reader
+    = decltype(LEXY_DECLVAL(const Reader&).end(), LEXY_DECLVAL(const Reader&).remaining(),
+               LEXY_DECLVAL(Reader&).advance(std::size_t(0)));
+
+/// Whether the reader is a ContiguousReader, i.e. a pointer into an array with a known end.
+template <typename Reader>
+constexpr bool is_contiguous_reader = [] {
+    if constexpr (!std::is_pointer_v<typename Reader::iterator>)
+        return false;
+    else
+        return _detail::is_detected<_detect_contiguous_reader, Reader>;
+}();
+
+template <typename Reader>
+using _detect_reader_padding = decltype(Reader::padding);
+
+/// The number of bytes after the end of a ContiguousReader that can be read.
+template <typename Reader>
+constexpr std::size_t reader_padding = [] {
+    if constexpr (!is_contiguous_reader<Reader>)
+        return std::size_t(0);
+    else if constexpr (_detail::is_detected<_detect_reader_padding, Reader>)
+        return std::size_t(Reader::padding);
+    else
+        return std::size_t(0);
+}();
+
 /// Creates a reader that only reads until the given end.
 template <typename Reader>
 constexpr auto partial_reader(Reader reader, typename Reader::iterator end)
@@ -5,7 +5,9 @@
 #ifndef LEXY_INPUT_BUFFER_HPP_INCLUDED
 #define LEXY_INPUT_BUFFER_HPP_INCLUDED
 
+#include <cstdint>
 #include <cstring>
+#include <lexy/_detail/byte_swap.hpp>
 #include <lexy/_detail/memory_resource.hpp>
 #include <lexy/error.hpp>
 #include <lexy/input/base.hpp>
@@ -13,16 +15,48 @@
 
 namespace lexy
 {
+template <typename Encoding, typename MemoryResource, typename Policy>
+class shared_buffer;
+
+/// The default memory layout of a buffer: aligned for its characters, followed by an EOF sentinel
+/// if the encoding has one.
+struct default_buffer_policy
+{
+    static constexpr std::size_t alignment = 1;
+    static constexpr std::size_t padding   = 0;
+};
+
+/// Aligns the buffer to a cache line and guarantees that `Padding` bytes after the end can be read.
+/// The padding is filled with EOF sentinels, or zeroes if the encoding doesn't have one.
+template <std::size_t Padding = 64>
+struct padded_buffer_policy
+{
+    static constexpr std::size_t alignment = 64;
+    static constexpr std::size_t padding   = Padding;
+};
+
 /// Stores the input that will be parsed.
 /// For encodings with spare code points, it can append an EOF sentinel.
 /// This allows branch-less detection of EOF.
 template <typename Encoding       = default_encoding,
-          typename MemoryResource = _detail::default_memory_resource>
+          typename MemoryResource = _detail::default_memory_resource,
+          typename Policy         = default_buffer_policy>
 class buffer
 {
     static constexpr auto _has_sentinel
         = std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
 
+    // The number of characters allocated after the end.
+    static constexpr std::size_t _padding_size = [] {
+        using char_type = typename Encoding::char_type;
+        auto result     = (Policy::padding + sizeof(char_type) - 1) / sizeof(char_type);
+        return _has_sentinel && result == 0 ? std::size_t(1) : result;
+    }();
+    static constexpr std::size_t _alignment
+        = alignof(typename Encoding::char_type) > Policy::alignment
+              ? alignof(typename Encoding::char_type)
+              : Policy::alignment;
+
 public:
     using encoding  = Encoding;
     using char_type = typename encoding::char_type;
@@ -98,6 +132,30 @@ public:
     : buffer(view.data(), view.size(), resource)
     {}
 
+    /// Takes ownership of memory that contains the input in `[data, data + size)`.
+    /// There must be room for `adopt_capacity(size)` characters, so that the sentinel or padding
+    /// can be written after the input, and the memory must be aligned as required by the policy.
+    /// It is released by calling `resource->deallocate()` with that capacity.
+    static buffer adopt(
+        char_type* data, std::size_t size,
+        MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) noexcept
+    {
+        LEXY_PRECONDITION(data);
+        LEXY_PRECONDITION(reinterpret_cast<std::uintptr_t>(data) % _alignment == 0);
+
+        buffer result(resource);
+        result._data = data;
+        result._size = size;
+        _fill_padding(data, size);
+        return result;
+    }
+
+    /// The number of characters the memory passed to `adopt()` must have for the input size.
+    static constexpr std::size_t adopt_capacity(std::size_t size) noexcept
+    {
+        return size + _padding_size;
+    }
+
     buffer(const buffer& other) : buffer(other.data(), other.size(), other._resource.get()) {}
     buffer(const buffer& other, MemoryResource* resource)
     : buffer(other.data(), other.size(), resource)
@@ -115,10 +173,7 @@ public:
         if (!_data)
             return;
 
-        if constexpr (_has_sentinel)
-            _resource->deallocate(_data, (_size + 1) * sizeof(char_type), alignof(char_type));
-        else
-            _resource->deallocate(_data, _size * sizeof(char_type), alignof(char_type));
+        _resource->deallocate(_data, (_size + _padding_size) * sizeof(char_type), _alignment);
     }
 
     buffer& operator=(const buffer& other)
@@ -183,7 +238,9 @@ public:
     auto reader() const& noexcept
     {
         if constexpr (_has_sentinel)
-            return _sentinel_reader(_data);
+            return _sentinel_reader(_data, _data + _size);
+        else if constexpr (_padding_size > 0)
+            return _padded_reader(_data, _data + _size);
         else
             return _detail::range_reader<encoding, const char_type*>(_data, _data + _size);
     }
@@ -197,6 +254,8 @@ private:
         using iterator         = const char_type*;
         using canonical_reader = _sentinel_reader;
 
+        static constexpr std::size_t padding = _padding_size * sizeof(char_type);
+
         bool eof() const noexcept
         {
             return *_cur == encoding::eof();
@@ -218,28 +277,61 @@ private:
             return _cur;
         }
 
+        //=== contiguous reader ===//
+        // The end is only needed for bulk operations, EOF is still checked using the sentinel.
+        iterator end() const noexcept
+        {
+            return _end;
+        }
+        std::size_t remaining() const noexcept
+        {
+            return std::size_t(_end - _cur);
+        }
+        void advance(std::size_t n) noexcept
+        {
+            _cur += n;
+        }
+
     private:
-        explicit _sentinel_reader(iterator begin) noexcept : _cur(begin) {}
+        explicit _sentinel_reader(iterator begin, iterator end) noexcept : _cur(begin), _end(end)
+        {}
 
-        iterator _cur;
+        iterator _cur, _end;
         friend buffer;
     };
 
-    char_type* allocate(std::size_t size) const
+    struct _padded_reader : _detail::range_reader<encoding, const char_type*>
     {
-        if constexpr (_has_sentinel)
-            ++size;
+        using canonical_reader = _padded_reader;
+        using _detail::range_reader<encoding, const char_type*>::range_reader;
+
+        static constexpr std::size_t padding = _padding_size * sizeof(char_type);
+    };
+
+    static void _fill_padding(char_type* memory, std::size_t size) noexcept
+    {
+        for (auto ptr = memory + size; ptr != memory + size + _padding_size; ++ptr)
+        {
+            if constexpr (_has_sentinel)
+                *ptr = encoding::eof();
+            else
+                *ptr = char_type();
+        }
+    }
 
+    char_type* allocate(std::size_t size) const
+    {
         auto memory = static_cast<char_type*>(
-            _resource->allocate(size * sizeof(char_type), alignof(char_type)));
-        if constexpr (_has_sentinel)
-            memory[size - 1] = encoding::eof();
+            _resource->allocate((size + _padding_size) * sizeof(char_type), _alignment));
+        _fill_padding(memory, size);
         return memory;
     }
 
     LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
     char_type*                                                     _data;
     std::size_t                                                    _size;
+
+    friend shared_buffer<Encoding, MemoryResource, Policy>;
 };
 
 template <typename CharT>
@@ -260,13 +352,62 @@ buffer(const View&, MemoryResource*)
     -> buffer<deduce_encoding<std::decay_t<decltype(*LEXY_DECLVAL(View).data())>>, MemoryResource>;
 
 //=== make_buffer ===//
+struct _bom
+{
+    encoding_endianness endianness;
+    /// The size of the BOM in bytes, zero if there is none.
+    std::size_t size;
+};
+
+// Determines the byte order of the memory and the size of the BOM that needs to be skipped.
 template <typename Encoding, encoding_endianness Endian>
+constexpr _bom _detect_bom(const unsigned char* memory, std::size_t size) noexcept
+{
+    constexpr auto big    = encoding_endianness::big;
+    constexpr auto little = encoding_endianness::little;
+
+    if constexpr (Endian != encoding_endianness::bom)
+        return {Endian, 0};
+    else if constexpr (std::is_same_v<Encoding, utf8_encoding>)
+    {
+        // The BOM doesn't specify anything, we just skip it.
+        if (size >= 3 && memory[0] == 0xEF && memory[1] == 0xBB && memory[2] == 0xBF)
+            return {big, 3};
+        else
+            return {big, 0};
+    }
+    else if constexpr (std::is_same_v<Encoding, utf16_encoding>)
+    {
+        if (size >= 2 && memory[0] == 0xFF && memory[1] == 0xFE)
+            return {little, 2};
+        else if (size >= 2 && memory[0] == 0xFE && memory[1] == 0xFF)
+            return {big, 2};
+        else
+            return {big, 0};
+    }
+    else if constexpr (std::is_same_v<Encoding, utf32_encoding>)
+    {
+        if (size >= 4 && memory[0] == 0xFF && memory[1] == 0xFE && memory[2] == 0x00
+            && memory[3] == 0x00)
+            return {little, 4};
+        else if (size >= 4 && memory[0] == 0x00 && memory[1] == 0x00 && memory[2] == 0xFE
+                 && memory[3] == 0xFF)
+            return {big, 4};
+        else
+            return {big, 0};
+    }
+    else
+        return {big, 0};
+}
+
+template <typename Encoding, encoding_endianness Endian, typename Policy>
 struct _make_buffer
 {
     template <typename MemoryResource = _detail::default_memory_resource>
     auto operator()(const void* _memory, std::size_t size,
                     MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) const
     {
+        using buffer_type = buffer<Encoding, MemoryResource, Policy>;
         constexpr auto native_endianness
             = LEXY_IS_LITTLE_ENDIAN ? encoding_endianness::little : encoding_endianness::big;
 
@@ -274,109 +415,40 @@ struct _make_buffer
         LEXY_PRECONDITION(size % sizeof(char_type) == 0);
         auto memory = static_cast<const unsigned char*>(_memory);
 
-        if constexpr (sizeof(char_type) == 1 || Endian == native_endianness)
+        if constexpr (Endian == encoding_endianness::bom)
+        {
+            constexpr auto little = _make_buffer<Encoding, encoding_endianness::little, Policy>{};
+            constexpr auto big    = _make_buffer<Encoding, encoding_endianness::big, Policy>{};
+
+            // We skip the BOM and convert the rest in a single pass.
+            auto bom = _detect_bom<Encoding, Endian>(memory, size);
+            if (bom.endianness == encoding_endianness::little)
+                return little(memory + bom.size, size - bom.size, resource);
+            else
+                return big(memory + bom.size, size - bom.size, resource);
+        }
+        else if constexpr (sizeof(char_type) == 1 || Endian == native_endianness)
         {
             // No need to deal with endianness at all.
             // The reinterpret_cast is technically UB, as we didn't create objects in memory,
             // but until std::start_lifetime_as is added, there is nothing we can do.
-            return buffer<Encoding, MemoryResource>(reinterpret_cast<const char_type*>(memory),
-                                                    size / sizeof(char_type), resource);
+            return buffer_type(reinterpret_cast<const char_type*>(memory), size / sizeof(char_type),
+                               resource);
         }
         else
         {
-            typename buffer<Encoding, MemoryResource>::builder builder(size / sizeof(char_type),
-                                                                       resource);
-
-            const auto end = memory + size;
-            for (auto dest = builder.data(); memory != end; memory += sizeof(char_type))
-            {
-                constexpr auto is_char16 = std::is_same_v<char_type, char16_t>;
-                constexpr auto is_char32 = std::is_same_v<char_type, char32_t>;
-
-                // We convert each group of bytes to the appropriate value.
-                if constexpr (is_char16 && Endian == encoding_endianness::little)
-                    *dest++ = static_cast<char_type>((memory[0] << 0) | (memory[1] << 8));
-                else if constexpr (is_char32 && Endian == encoding_endianness::little)
-                    *dest++ = static_cast<char_type>((memory[0] << 0) | (memory[1] << 8)
-                                                     | (memory[2] << 16) | (memory[3] << 24));
-                else if constexpr (is_char16 && Endian == encoding_endianness::big)
-                    *dest++ = static_cast<char_type>((memory[0] << 8) | (memory[1] << 0));
-                else if constexpr (is_char32 && Endian == encoding_endianness::big)
-                    *dest++ = static_cast<char_type>((memory[0] << 24) | (memory[1] << 16)
-                                                     | (memory[2] << 8) | (memory[3] << 0));
-                else
-                    static_assert(_detail::error<Encoding>, "unhandled encoding/endianness");
-            }
-
+            // We need to reverse the bytes of each code unit, which we can do in bulk.
+            typename buffer_type::builder builder(size / sizeof(char_type), resource);
+            _detail::copy_byte_swapped(builder.data(), memory, builder.size());
             return LEXY_MOV(builder).finish();
         }
     }
 };
-template <>
-struct _make_buffer<utf8_encoding, encoding_endianness::bom>
-{
-    template <typename MemoryResource = _detail::default_memory_resource>
-    auto operator()(const void* _memory, std::size_t size,
-                    MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) const
-    {
-        auto memory = static_cast<const unsigned char*>(_memory);
-
-        // We just skip over the BOM if there is one, it doesn't matter.
-        if (size >= 3 && memory[0] == 0xEF && memory[1] == 0xBB && memory[2] == 0xBF)
-        {
-            memory += 3;
-            size -= 3;
-        }
-
-        return _make_buffer<utf8_encoding, encoding_endianness::big>{}(memory, size, resource);
-    }
-};
-template <>
-struct _make_buffer<utf16_encoding, encoding_endianness::bom>
-{
-    template <typename MemoryResource = _detail::default_memory_resource>
-    auto operator()(const void* _memory, std::size_t size,
-                    MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) const
-    {
-        constexpr auto utf16_big    = _make_buffer<utf16_encoding, encoding_endianness::big>{};
-        constexpr auto utf16_little = _make_buffer<utf16_encoding, encoding_endianness::little>{};
-        auto           memory       = static_cast<const unsigned char*>(_memory);
-
-        if (size < 2)
-            return utf16_big(memory, size, resource);
-        if (memory[0] == 0xFF && memory[1] == 0xFE)
-            return utf16_little(memory + 2, size - 2, resource);
-        else if (memory[0] == 0xFE && memory[1] == 0xFF)
-            return utf16_big(memory + 2, size - 2, resource);
-        else
-            return utf16_big(memory, size, resource);
-    }
-};
-template <>
-struct _make_buffer<utf32_encoding, encoding_endianness::bom>
-{
-    template <typename MemoryResource = _detail::default_memory_resource>
-    auto operator()(const void* _memory, std::size_t size,
-                    MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) const
-    {
-        constexpr auto utf32_big    = _make_buffer<utf32_encoding, encoding_endianness::big>{};
-        constexpr auto utf32_little = _make_buffer<utf32_encoding, encoding_endianness::little>{};
-        auto           memory       = static_cast<const unsigned char*>(_memory);
-
-        if (size < 4)
-            return utf32_big(memory, size, resource);
-        else if (memory[0] == 0xFF && memory[1] == 0xFE && memory[2] == 0x00 && memory[3] == 0x00)
-            return utf32_little(memory + 4, size - 4, resource);
-        else if (memory[0] == 0x00 && memory[1] == 0x00 && memory[2] == 0xFE && memory[3])
-            return utf32_big(memory + 4, size - 4, resource);
-        else
-            return utf32_big(memory, size, resource);
-    }
-};
 
 /// Creates a buffer with the specified encoding/endianness from raw memory.
-template <typename Encoding, encoding_endianness Endianness>
-constexpr auto make_buffer = _make_buffer<Encoding, Endianness>{};
+template <typename Encoding, encoding_endianness Endianness,
+          typename Policy = default_buffer_policy>
+constexpr auto make_buffer = _make_buffer<Encoding, Endianness, Policy>{};
 
 //=== convenience typedefs ===//
 template <typename Encoding       = default_encoding,
@@ -390,6 +462,10 @@ using buffer_error = error_for<buffer<Encoding, MemoryResource>, Tag>;
 template <typename Production, typename Encoding = default_encoding,
           typename MemoryResource = _detail::default_memory_resource>
 using buffer_error_context = error_context<Production, buffer<Encoding, MemoryResource>>;
+
+template <typename Encoding = default_encoding, std::size_t Padding = 64,
+          typename MemoryResource = _detail::default_memory_resource>
+using padded_buffer = buffer<Encoding, MemoryResource, padded_buffer_policy<Padding>>;
 } // namespace lexy
 
 #endif // LEXY_INPUT_BUFFER_HPP_INCLUDED
@@ -5,6 +5,7 @@
 #ifndef LEXY_INPUT_FILE_HPP_INCLUDED
 #define LEXY_INPUT_FILE_HPP_INCLUDED
 
+#include <lexy/_detail/detect.hpp>
 #include <lexy/_detail/std.hpp>
 #include <lexy/input/base.hpp>
 #include <lexy/input/buffer.hpp>
@@ -27,48 +28,99 @@ enum class file_error
 
 namespace lexy::_detail
 {
-using file_callback = void (*)(void* user_data, const char* memory, std::size_t size);
+using file_allocate_callback = void* (*)(void* user_data, std::size_t size);
 
-// Reads the entire contents of the specified file into memory.
-// On success, invokes the callback before freeing the memory.
-// On error, returns the error without invoking the callback.
+// Reads the entire contents of the specified file into memory returned by the callback.
+// On success, the callback has been invoked last with the size of the file;
+// if the size reported by the OS was wrong, it has been invoked with that size before.
+// On error, the callback might have been invoked or not.
 //
 // Do not change ABI, especially with different build configurations!
-file_error read_file(const char* path, file_callback cb, void* user_data);
+file_error read_file_into(const char* path, file_allocate_callback allocate, void* user_data);
 } // namespace lexy::_detail
 
 namespace lexy
 {
-/// Reads the file at the specified path into a buffer.
+template <typename Policy>
+using _detect_buffer_policy = decltype(Policy::alignment, Policy::padding);
+
+/// Reads the file at the specified path into a buffer with the given policy, e.g. to pad it.
 template <typename Encoding          = default_encoding,
-          encoding_endianness Endian = encoding_endianness::bom,
-          typename MemoryResource    = _detail::default_memory_resource>
-auto read_file(const char*     path,
+          encoding_endianness Endian = encoding_endianness::bom, typename Policy,
+          typename MemoryResource = _detail::default_memory_resource,
+          typename = std::enable_if_t<_detail::is_detected<_detect_buffer_policy, Policy>>>
+auto read_file(const char* path, Policy,
                MemoryResource* resource = _detail::get_memory_resource<MemoryResource>())
-    -> result<buffer<Encoding, MemoryResource>, file_error>
+    -> result<buffer<Encoding, MemoryResource, Policy>, file_error>
 {
-    using buffer_type = buffer<Encoding, MemoryResource>;
+    using buffer_type = buffer<Encoding, MemoryResource, Policy>;
+    using char_type   = typename Encoding::char_type;
 
     struct user_data_t
     {
         buffer_type     buffer;
+        char_type*      memory;
+        std::size_t     size;
         MemoryResource* resource;
-    } user_data{buffer_type(resource), resource};
+    } user_data{buffer_type(resource), nullptr, 0, resource};
 
-    auto error = _detail::read_file(
+    // We read the bytes directly into the buffer and convert them in place.
+    auto error = _detail::read_file_into(
         path,
-        [](void* _user_data, const char* memory, std::size_t size) {
+        [](void* _user_data, std::size_t size) -> void* {
             auto user_data = static_cast<user_data_t*>(_user_data);
 
-            user_data->buffer
-                = lexy::make_buffer<Encoding, Endian>(memory, size, user_data->resource);
+            // A trailing incomplete code unit is filled with zeroes.
+            typename buffer_type::builder builder((size + sizeof(char_type) - 1)
+                                                      / sizeof(char_type),
+                                                  user_data->resource);
+            if (size % sizeof(char_type) != 0)
+                builder.data()[builder.size() - 1] = char_type(0);
+
+            user_data->memory = builder.data();
+            user_data->size   = size;
+            user_data->buffer = LEXY_MOV(builder).finish();
+            return user_data->memory;
         },
         &user_data);
-
-    if (error == file_error::_success)
-        return {lexy::result_value, LEXY_MOV(user_data.buffer)};
-    else
+    if (error != file_error::_success)
         return {lexy::result_error, error};
+
+    auto& buffer = user_data.buffer;
+    auto  bytes  = reinterpret_cast<const unsigned char*>(user_data.memory);
+    auto  bom    = _detect_bom<Encoding, Endian>(bytes, user_data.size);
+    if (bom.size > 0)
+    {
+        // Like make_buffer(), we skip the BOM, which requires a copy.
+        constexpr auto little = make_buffer<Encoding, encoding_endianness::little, Policy>;
+        constexpr auto big    = make_buffer<Encoding, encoding_endianness::big, Policy>;
+
+        auto size = buffer.size() * sizeof(char_type) - bom.size;
+        if (bom.endianness == encoding_endianness::little)
+            buffer = little(bytes + bom.size, size, resource);
+        else
+            buffer = big(bytes + bom.size, size, resource);
+    }
+    else if constexpr (sizeof(char_type) > 1)
+    {
+        constexpr auto native_endianness
+            = LEXY_IS_LITTLE_ENDIAN ? encoding_endianness::little : encoding_endianness::big;
+        if (bom.endianness != native_endianness)
+            _detail::copy_byte_swapped(user_data.memory, bytes, buffer.size());
+    }
+
+    return {lexy::result_value, LEXY_MOV(buffer)};
+}
+
+/// Reads the file at the specified path into a buffer.
+template <typename Encoding          = default_encoding,
+          encoding_endianness Endian = encoding_endianness::bom,
+          typename MemoryResource    = _detail::default_memory_resource>
+auto read_file(const char*     path,
+               MemoryResource* resource = _detail::get_memory_resource<MemoryResource>())
+    -> result<buffer<Encoding, MemoryResource>, file_error>
+{
+    return lexy::read_file<Encoding, Endian>(path, default_buffer_policy{}, resource);
 }
 } // namespace lexy
 
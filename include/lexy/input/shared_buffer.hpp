@@ -0,0 +1,212 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_INPUT_SHARED_BUFFER_HPP_INCLUDED
+#define LEXY_INPUT_SHARED_BUFFER_HPP_INCLUDED
+
+#include <atomic>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/input/buffer.hpp>
+#include <lexy/lexeme.hpp>
+#include <new>
+
+namespace lexy
+{
+/// A `buffer` with shared ownership: copies refer to the same input, which is freed when the last
+/// one is destroyed. The reference count is atomic, so copies can be used in different threads.
+template <typename Encoding       = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource,
+          typename Policy         = default_buffer_policy>
+class shared_buffer
+{
+public:
+    using buffer_type = buffer<Encoding, MemoryResource, Policy>;
+    using encoding    = Encoding;
+    using char_type   = typename encoding::char_type;
+
+    //=== constructors ===//
+    /// An empty buffer without an input; it has no reader.
+    constexpr shared_buffer() noexcept : _block(nullptr) {}
+
+    /// Takes ownership of the buffer.
+    /// The reference count is allocated using the memory resource of the buffer.
+    explicit shared_buffer(buffer_type&& buffer)
+    {
+        auto resource = buffer._resource;
+        auto memory   = resource->allocate(sizeof(_block_t), alignof(_block_t));
+        _block        = ::new (memory) _block_t{{1}, LEXY_MOV(buffer)};
+    }
+
+    shared_buffer(const shared_buffer& other) noexcept : _block(other._block)
+    {
+        if (_block)
+            _block->count.fetch_add(1, std::memory_order_relaxed);
+    }
+    shared_buffer(shared_buffer&& other) noexcept : _block(other._block)
+    {
+        other._block = nullptr;
+    }
+
+    ~shared_buffer() noexcept
+    {
+        if (!_block || _block->count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        // We were the last owner, so we destroy the buffer and free the block.
+        auto resource = _block->buffer._resource;
+        _block->~_block_t();
+        resource->deallocate(_block, sizeof(_block_t), alignof(_block_t));
+    }
+
+    shared_buffer& operator=(const shared_buffer& other) noexcept
+    {
+        auto copy(other);
+        _detail::swap(_block, copy._block);
+        return *this;
+    }
+    shared_buffer& operator=(shared_buffer&& other) noexcept
+    {
+        auto copy(LEXY_MOV(other));
+        _detail::swap(_block, copy._block);
+        return *this;
+    }
+
+    //=== access ===//
+    /// The number of `shared_buffer` objects that refer to the input, zero if there is none.
+    std::size_t use_count() const noexcept
+    {
+        return _block ? _block->count.load(std::memory_order_relaxed) : 0;
+    }
+
+    const char_type* begin() const noexcept
+    {
+        return _block ? _block->buffer.begin() : nullptr;
+    }
+    const char_type* end() const noexcept
+    {
+        return _block ? _block->buffer.end() : nullptr;
+    }
+
+    const char_type* data() const noexcept
+    {
+        return begin();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _block ? _block->buffer.size() : 0;
+    }
+    std::size_t length() const noexcept
+    {
+        return size();
+    }
+
+    //=== input ===//
+    auto reader() const& noexcept
+    {
+        LEXY_PRECONDITION(_block);
+        return _block->buffer.reader();
+    }
+
+private:
+    struct _block_t
+    {
+        std::atomic<std::size_t> count;
+        buffer_type              buffer;
+    };
+
+    _block_t* _block;
+};
+
+template <typename Encoding, typename MemoryResource, typename Policy>
+shared_buffer(buffer<Encoding, MemoryResource, Policy>&&)
+    -> shared_buffer<Encoding, MemoryResource, Policy>;
+
+/// A lexeme of a `shared_buffer` that keeps the input alive.
+/// If it doesn't own the buffer, it is just a lexeme.
+template <typename Encoding       = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource,
+          typename Policy         = default_buffer_policy>
+class shared_lexeme
+{
+public:
+    using buffer_type = shared_buffer<Encoding, MemoryResource, Policy>;
+    using lexeme_type = lexeme_for<buffer_type>;
+
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+    using iterator  = typename lexeme_type::iterator;
+
+    shared_lexeme() noexcept = default;
+
+    /// A lexeme that doesn't keep the input alive.
+    explicit shared_lexeme(lexeme_type lexeme) noexcept : _buffer(), _lexeme(lexeme) {}
+
+    /// A lexeme into the buffer that keeps the input alive.
+    explicit shared_lexeme(buffer_type buffer, lexeme_type lexeme) noexcept
+    : _buffer(LEXY_MOV(buffer)), _lexeme(lexeme)
+    {
+        LEXY_PRECONDITION(_lexeme.empty()
+                          || (_buffer.begin() <= _lexeme.begin()
+                              && _lexeme.end() <= _buffer.end()));
+    }
+
+    //=== access ===//
+    /// The buffer that is kept alive, if any.
+    const buffer_type& buffer() const noexcept
+    {
+        return _buffer;
+    }
+    lexeme_type lexeme() const noexcept
+    {
+        return _lexeme;
+    }
+
+    bool empty() const noexcept
+    {
+        return _lexeme.empty();
+    }
+
+    iterator begin() const noexcept
+    {
+        return _lexeme.begin();
+    }
+    iterator end() const noexcept
+    {
+        return _lexeme.end();
+    }
+
+    const char_type* data() const noexcept
+    {
+        return _lexeme.data();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _lexeme.size();
+    }
+
+    char_type operator[](std::size_t idx) const noexcept
+    {
+        return _lexeme[idx];
+    }
+
+private:
+    buffer_type _buffer;
+    lexeme_type _lexeme;
+};
+
+template <typename Encoding, typename MemoryResource, typename Policy>
+shared_lexeme(shared_buffer<Encoding, MemoryResource, Policy>,
+              lexeme_for<shared_buffer<Encoding, MemoryResource, Policy>>)
+    -> shared_lexeme<Encoding, MemoryResource, Policy>;
+} // namespace lexy
+
+#endif // LEXY_INPUT_SHARED_BUFFER_HPP_INCLUDED
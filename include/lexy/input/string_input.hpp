@@ -101,6 +101,85 @@ constexpr auto zstring_input(const CharT* str) noexcept
     return zstring_input<deduce_encoding<CharT>>(str);
 }
 
+/// An input that refers to a null-terminated string.
+/// Unlike `zstring_input()`, it doesn't compute the length of the string:
+/// the reader uses the null character as EOF sentinel instead of comparing against an end.
+template <typename Encoding = default_encoding>
+class cstring_input
+{
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+
+    using iterator = const char_type*;
+
+    //=== constructors ===//
+    constexpr cstring_input() noexcept : _str(&_empty) {}
+
+    constexpr explicit cstring_input(const char_type* str) noexcept : _str(str) {}
+
+    template <typename CharT, typename = _require_secondary_char_type<Encoding, CharT>>
+    explicit cstring_input(const CharT* str) noexcept : _str(reinterpret_cast<iterator>(str))
+    {}
+
+    //=== access ===//
+    constexpr iterator begin() const noexcept
+    {
+        return _str;
+    }
+
+    //=== reader ===//
+    class _reader
+    {
+    public:
+        using encoding         = Encoding;
+        using char_type        = typename encoding::char_type;
+        using iterator         = const char_type*;
+        using canonical_reader = _reader;
+
+        constexpr bool eof() const noexcept
+        {
+            return *_cur == char_type();
+        }
+
+        constexpr auto peek() const noexcept
+        {
+            // For encodings where char_type == int_type, this is a conditional move.
+            auto c = *_cur;
+            return c == char_type() ? encoding::eof() : encoding::to_int_type(c);
+        }
+
+        constexpr void bump() noexcept
+        {
+            ++_cur;
+        }
+
+        constexpr iterator cur() const noexcept
+        {
+            return _cur;
+        }
+
+    private:
+        constexpr explicit _reader(iterator begin) noexcept : _cur(begin) {}
+
+        iterator _cur;
+        friend cstring_input;
+    };
+
+    constexpr auto reader() const& noexcept
+    {
+        return _reader(_str);
+    }
+
+private:
+    static constexpr char_type _empty = char_type();
+
+    iterator _str;
+};
+
+template <typename CharT>
+cstring_input(const CharT* str) -> cstring_input<deduce_encoding<CharT>>;
+
 //=== convenience typedefs ===//
 template <typename Encoding = default_encoding>
 using string_lexeme = lexeme_for<string_input<Encoding>>;
@@ -110,6 +189,15 @@ using string_error = error_for<string_input<Encoding>, Tag>;
 
 template <typename Production, typename Encoding = default_encoding>
 using string_error_context = error_context<Production, string_input<Encoding>>;
+
+template <typename Encoding = default_encoding>
+using cstring_lexeme = lexeme_for<cstring_input<Encoding>>;
+
+template <typename Tag, typename Encoding = default_encoding>
+using cstring_error = error_for<cstring_input<Encoding>, Tag>;
+
+template <typename Production, typename Encoding = default_encoding>
+using cstring_error_context = error_context<Production, cstring_input<Encoding>>;
 } // namespace lexy
 
 #endif // LEXY_INPUT_STRING_INPUT_HPP_INCLUDED
@@ -6,6 +6,7 @@
 #define LEXY_MATCH_HPP_INCLUDED
 
 #include <lexy/callback.hpp>
+#include <lexy/dsl/base.hpp>
 #include <lexy/production.hpp>
 #include <lexy/result.hpp>
 
@@ -44,16 +45,58 @@ struct _match_handler
     }
 };
 
-template <typename Production, typename Input>
-constexpr bool match(const Input& input)
+template <>
+constexpr bool _handler_discards_values<_match_handler> = true;
+
+template <typename Production, typename Reader>
+constexpr bool _match(Reader& reader)
 {
     auto                handler = _match_handler{};
-    auto                reader  = input.reader();
     lexy::parse_context context(Production{}, handler, reader.cur());
 
     using rule = lexy::production_rule<Production>;
     return lexy::rule_parser<rule, lexy::context_value_parser>::parse(context, reader).has_value();
 }
+
+template <typename Production, typename Input>
+constexpr bool match(const Input& input)
+{
+    auto reader = input.reader();
+    return _match<Production>(reader);
+}
+
+template <typename Input>
+using _detect_reader = decltype(LEXY_DECLVAL(const Input&).reader());
+
+/// Matches the production at the beginning of the input.
+/// If it matches, returns the position where the match ended.
+template <typename Production, typename Input,
+          typename = std::enable_if_t<_detail::is_detected<_detect_reader, Input>>>
+constexpr auto match_prefix(const Input& input)
+    -> lexy::result<typename input_reader<Input>::iterator, void>
+{
+    auto reader = input.reader();
+    if (_match<Production>(reader))
+        return lexy::result<typename input_reader<Input>::iterator, void>(lexy::result_value,
+                                                                          reader.cur());
+    else
+        return lexy::result<typename input_reader<Input>::iterator, void>(lexy::result_error);
+}
+
+/// Matches the production at the current position of the reader.
+/// If it matches, advances the reader to the position where the match ended and returns it,
+/// otherwise, leaves the reader unchanged.
+template <typename Production, typename Reader,
+          typename = std::enable_if_t<!_detail::is_detected<_detect_reader, Reader>>>
+constexpr auto match_prefix(Reader& reader) -> lexy::result<typename Reader::iterator, void>
+{
+    auto save = reader;
+    if (_match<Production>(reader))
+        return lexy::result<typename Reader::iterator, void>(lexy::result_value, reader.cur());
+
+    reader = LEXY_MOV(save);
+    return lexy::result<typename Reader::iterator, void>(lexy::result_error);
+}
 } // namespace lexy
 
 #endif // LEXY_MATCH_HPP_INCLUDED
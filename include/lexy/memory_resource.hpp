@@ -0,0 +1,253 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_MEMORY_RESOURCE_HPP_INCLUDED
+#define LEXY_MEMORY_RESOURCE_HPP_INCLUDED
+
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/memory_resource.hpp>
+#include <mutex>
+
+#if defined(__linux__)
+#    include <sys/mman.h>
+#endif
+
+//=== buffer_pool ===//
+namespace lexy
+{
+/// A thread-safe MemoryResource that keeps freed memory around to reuse it for the next buffer.
+/// Allocations are rounded up to a power of two size class, and each size class has a free list.
+/// Big allocations and allocations with an alignment bigger than a cache line aren't pooled.
+class buffer_pool
+{
+public:
+    /// The smallest size class.
+    static constexpr std::size_t min_size = std::size_t(1) << 8;
+    /// Allocations bigger than that are not pooled.
+    static constexpr std::size_t max_size = std::size_t(1) << 26;
+
+    //=== constructors ===//
+    /// Keeps at most `max_cached_bytes` of freed memory.
+    explicit buffer_pool(std::size_t max_cached_bytes = std::size_t(1) << 26) noexcept
+    : _free{}, _cached_bytes(0), _max_cached_bytes(max_cached_bytes)
+    {}
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool& operator=(const buffer_pool&) = delete;
+
+    /// All memory allocated from the pool must have been deallocated already.
+    ~buffer_pool() noexcept
+    {
+        release();
+    }
+
+    //=== memory resource ===//
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if (bytes > max_size || alignment > _alignment)
+            return _upstream.allocate(bytes, alignment);
+
+        auto cls = _size_class(bytes);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (auto node = _free[cls])
+            {
+                _free[cls] = node->next;
+                _cached_bytes -= _class_size(cls);
+                return node;
+            }
+        }
+
+        return _upstream.allocate(_class_size(cls), _alignment);
+    }
+
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+        if (bytes > max_size || alignment > _alignment)
+        {
+            _upstream.deallocate(ptr, bytes, alignment);
+            return;
+        }
+
+        auto cls  = _size_class(bytes);
+        auto size = _class_size(cls);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_cached_bytes + size <= _max_cached_bytes)
+            {
+                _free[cls] = ::new (ptr) _node{_free[cls]};
+                _cached_bytes += size;
+                return;
+            }
+        }
+
+        _upstream.deallocate(ptr, size, _alignment);
+    }
+
+    friend bool operator==(const buffer_pool& lhs, const buffer_pool& rhs) noexcept
+    {
+        return &lhs == &rhs;
+    }
+
+    //=== cache ===//
+    /// The number of bytes of freed memory that is kept for reuse.
+    std::size_t cached_bytes() const noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cached_bytes;
+    }
+
+    /// Frees the memory that is kept for reuse.
+    void release() noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto cls = std::size_t(0); cls != _class_count; ++cls)
+        {
+            while (auto node = _free[cls])
+            {
+                _free[cls] = node->next;
+                _upstream.deallocate(node, _class_size(cls), _alignment);
+            }
+        }
+        _cached_bytes = 0;
+    }
+
+private:
+    // Memory is aligned to a cache line, which also allows padded buffers.
+    static constexpr std::size_t _alignment = 64;
+
+    static constexpr std::size_t _class_count = [] {
+        auto result = std::size_t(1);
+        for (auto size = min_size; size != max_size; size *= 2)
+            ++result;
+        return result;
+    }();
+
+    static std::size_t _size_class(std::size_t bytes) noexcept
+    {
+        auto cls = std::size_t(0);
+        while (_class_size(cls) < bytes)
+            ++cls;
+        return cls;
+    }
+    static constexpr std::size_t _class_size(std::size_t cls) noexcept
+    {
+        return min_size << cls;
+    }
+
+    struct _node
+    {
+        _node* next;
+    };
+
+    mutable std::mutex                                 _mutex;
+    _node*                                             _free[_class_count];
+    std::size_t                                        _cached_bytes, _max_cached_bytes;
+    LEXY_EMPTY_MEMBER _detail::default_memory_resource _upstream;
+};
+} // namespace lexy
+
+//=== huge_page_resource ===//
+namespace lexy
+{
+/// A MemoryResource that backs allocations of at least `threshold` bytes by huge pages, which
+/// reduces TLB misses when scanning big inputs.
+///
+/// On Linux, it first tries explicit huge pages (`MAP_HUGETLB`), which need to be reserved by the
+/// system administrator; if there are none, it uses normal pages and asks for transparent huge
+/// pages using `madvise()`. Smaller allocations, allocations that can't be mapped, and all
+/// allocations on other systems, use `new`.
+class huge_page_resource
+{
+public:
+    /// The size of a huge page on x86-64 and the default size on AArch64.
+    static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+    //=== constructors ===//
+    constexpr explicit huge_page_resource(std::size_t threshold = huge_page_size) noexcept
+    : _threshold(threshold)
+    {}
+
+    constexpr std::size_t threshold() const noexcept
+    {
+        return _threshold;
+    }
+
+    //=== memory resource ===//
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+#if defined(__linux__)
+        if (_use_pages(bytes, alignment))
+        {
+            auto size   = _page_size(bytes + 1);
+            auto memory = MAP_FAILED;
+#    if defined(MAP_HUGETLB)
+            memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#    endif
+            if (memory == MAP_FAILED)
+            {
+                memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                                -1, 0);
+#    if defined(MADV_HUGEPAGE)
+                // If transparent huge pages are disabled, we just keep normal pages.
+                if (memory != MAP_FAILED)
+                    ::madvise(memory, size, MADV_HUGEPAGE);
+#    endif
+            }
+
+            // If we can't map memory, `new` reports the failure.
+            auto result = static_cast<unsigned char*>(
+                memory != MAP_FAILED
+                    ? memory
+                    : _detail::default_memory_resource{}.allocate(bytes + 1, alignment));
+            // We remember after the end how the memory was allocated, for deallocate().
+            result[bytes] = memory != MAP_FAILED;
+            return result;
+        }
+#endif
+        return _detail::default_memory_resource{}.allocate(bytes, alignment);
+    }
+
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment) noexcept
+    {
+#if defined(__linux__)
+        if (_use_pages(bytes, alignment))
+        {
+            if (static_cast<unsigned char*>(ptr)[bytes] != 0)
+                ::munmap(ptr, _page_size(bytes + 1));
+            else
+                _detail::default_memory_resource{}.deallocate(ptr, bytes + 1, alignment);
+            return;
+        }
+#endif
+        _detail::default_memory_resource{}.deallocate(ptr, bytes, alignment);
+    }
+
+    friend constexpr bool operator==(const huge_page_resource& lhs,
+                                     const huge_page_resource& rhs) noexcept
+    {
+        // Both use the same memory for the same size, so they can free each other's memory.
+        return lhs._threshold == rhs._threshold;
+    }
+
+private:
+    constexpr bool _use_pages(std::size_t bytes, std::size_t alignment) const noexcept
+    {
+        // mmap() returns memory aligned to a page, which is at least 4 KiB.
+        return bytes >= _threshold && bytes > 0 && alignment <= 4096;
+    }
+
+    // Explicit huge pages require the size to be a multiple of the huge page size.
+    static constexpr std::size_t _page_size(std::size_t bytes) noexcept
+    {
+        return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+    std::size_t _threshold;
+};
+} // namespace lexy
+
+#endif // LEXY_MEMORY_RESOURCE_HPP_INCLUDED
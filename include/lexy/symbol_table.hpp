@@ -0,0 +1,474 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_SYMBOL_TABLE_HPP_INCLUDED
+#define LEXY_SYMBOL_TABLE_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/_detail/string_view.hpp>
+#include <lexy/encoding.hpp>
+#include <lexy/parse.hpp>
+
+namespace lexy
+{
+/// A set of strings that is only known at runtime, mapping each string to its index.
+///
+/// It is stored as a double-array trie over the bytes of the code units:
+/// each transition is a single indexed load followed by a comparison.
+template <typename Encoding       = default_encoding,
+          typename MemoryResource = _detail::default_memory_resource>
+class symbol_table
+{
+    struct _node
+    {
+        // Index of the first child, the child for byte `b` is at `base + b`.
+        std::uint32_t base;
+        // Index of the parent node, or `_no_node` for a free slot.
+        std::uint32_t check;
+        // The id of the string that ends at this node, or `_no_id`.
+        std::uint32_t id;
+    };
+
+    static constexpr auto _no_node        = std::uint32_t(-1);
+    static constexpr auto _no_id          = std::uint32_t(-1);
+    static constexpr auto _bytes_per_char = sizeof(typename Encoding::char_type);
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+    using string    = _detail::basic_string_view<char_type>;
+
+    /// Returned if a string is not in the table.
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    //=== constructors ===//
+    constexpr symbol_table() noexcept : symbol_table(_detail::get_memory_resource<MemoryResource>())
+    {}
+
+    constexpr explicit symbol_table(MemoryResource* resource) noexcept
+    : _resource(resource), _nodes(nullptr), _capacity(0), _size(0)
+    {}
+
+    /// Builds the table from a range of strings, the id of each string is its index in the range.
+    /// If a string occurs multiple times, it has the id of its first occurrence.
+    template <typename Range, typename = decltype(LEXY_DECLVAL(const Range&).begin())>
+    explicit symbol_table(const Range&    strings,
+                          MemoryResource* resource = _detail::get_memory_resource<MemoryResource>())
+    : symbol_table(resource)
+    {
+        _build(strings.begin(), strings.end());
+    }
+    explicit symbol_table(std::initializer_list<string> strings,
+                          MemoryResource* resource = _detail::get_memory_resource<MemoryResource>())
+    : symbol_table(resource)
+    {
+        _build(strings.begin(), strings.end());
+    }
+
+    symbol_table(const symbol_table& other) : symbol_table(other, other._resource.get()) {}
+    symbol_table(const symbol_table& other, MemoryResource* resource) : symbol_table(resource)
+    {
+        if (!other._nodes)
+            return;
+
+        _nodes    = _allocate(other._capacity);
+        _capacity = other._capacity;
+        _size     = other._size;
+        std::memcpy(_nodes, other._nodes, _capacity * sizeof(_node));
+    }
+
+    symbol_table(symbol_table&& other) noexcept
+    : _resource(other._resource), _nodes(other._nodes), _capacity(other._capacity),
+      _size(other._size)
+    {
+        other._nodes    = nullptr;
+        other._capacity = 0;
+        other._size     = 0;
+    }
+
+    ~symbol_table() noexcept
+    {
+        if (_nodes)
+            _resource->deallocate(_nodes, _capacity * sizeof(_node), alignof(_node));
+    }
+
+    symbol_table& operator=(const symbol_table& other)
+    {
+        return *this = symbol_table(other, _resource.get());
+    }
+
+    symbol_table& operator=(symbol_table&& other) noexcept(std::is_empty_v<MemoryResource>)
+    {
+        if (*_resource == *other._resource)
+        {
+            _detail::swap(_nodes, other._nodes);
+            _detail::swap(_capacity, other._capacity);
+            _detail::swap(_size, other._size);
+            return *this;
+        }
+        else
+        {
+            LEXY_PRECONDITION(!std::is_empty_v<MemoryResource>);
+
+            symbol_table copy(other, _resource.get());
+            _detail::swap(_nodes, copy._nodes);
+            _detail::swap(_capacity, copy._capacity);
+            _detail::swap(_size, copy._size);
+            return *this;
+        }
+    }
+
+    //=== access ===//
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    /// The number of distinct strings in the table.
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// Returns the id of the string [begin, end), or `npos` if it isn't in the table.
+    template <typename Iterator, typename Sentinel>
+    std::size_t lookup(Iterator begin, Sentinel end) const noexcept
+    {
+        if (!_nodes)
+            return npos;
+
+        auto node = std::uint32_t(0);
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            node = _transition(node, *iter);
+            if (node == _no_node)
+                return npos;
+        }
+
+        return _nodes[node].id == _no_id ? npos : _nodes[node].id;
+    }
+    std::size_t lookup(string str) const noexcept
+    {
+        return lookup(str.begin(), str.end());
+    }
+
+    /// Matches the longest string of the table at the current reader position.
+    /// On success, the reader is advanced past it and its id returned;
+    /// otherwise, the reader is unchanged and `npos` returned.
+    template <typename Reader>
+    std::size_t match(Reader& reader) const noexcept
+    {
+        static_assert(std::is_same_v<typename Reader::encoding, encoding>);
+        if (!_nodes)
+            return npos;
+
+        // The root node is the empty string, which always matches.
+        auto result = _nodes[0].id == _no_id ? npos : std::size_t(_nodes[0].id);
+        auto end    = reader;
+
+        auto node = std::uint32_t(0);
+        while (true)
+        {
+            auto c = reader.peek();
+            if (c == encoding::eof())
+                break;
+
+            node = _transition(node, static_cast<char_type>(c));
+            if (node == _no_node)
+                break;
+            reader.bump();
+
+            if (auto id = _nodes[node].id; id != _no_id)
+            {
+                result = id;
+                end    = reader;
+            }
+        }
+
+        reader = LEXY_MOV(end);
+        return result;
+    }
+
+private:
+    // Returns the child of `node` for the given code unit, or `_no_node`.
+    // Note that every node has at least 256 slots following its base, so no bounds check is needed.
+    std::uint32_t _transition(std::uint32_t node, char_type c) const noexcept
+    {
+        for (auto i = _bytes_per_char; i > 0; --i)
+        {
+            auto next = _nodes[node].base + _byte(c, i - 1);
+            if (_nodes[next].check != node)
+                return _no_node;
+            node = next;
+        }
+        return node;
+    }
+
+    // Returns the idx-th byte of the code unit; bytes are stored with the most significant first.
+    static constexpr std::uint32_t _byte(char_type c, std::size_t idx) noexcept
+    {
+        using unsigned_t = std::make_unsigned_t<char_type>;
+        return std::uint32_t((unsigned_t(c) >> (idx * 8)) & 0xFF);
+    }
+
+    _node* _allocate(std::size_t capacity)
+    {
+        return static_cast<_node*>(_resource->allocate(capacity * sizeof(_node), alignof(_node)));
+    }
+
+    void _reserve(std::size_t capacity)
+    {
+        if (capacity <= _capacity)
+            return;
+
+        auto new_capacity = _capacity == 0 ? std::size_t(1024) : _capacity;
+        while (new_capacity < capacity)
+            new_capacity *= 2;
+
+        auto nodes = _allocate(new_capacity);
+        if (_nodes)
+        {
+            std::memcpy(nodes, _nodes, _capacity * sizeof(_node));
+            _resource->deallocate(_nodes, _capacity * sizeof(_node), alignof(_node));
+        }
+        for (auto i = _capacity; i != new_capacity; ++i)
+            nodes[i] = _node{0, _no_node, _no_id};
+
+        _nodes    = nodes;
+        _capacity = new_capacity;
+    }
+
+    template <typename T>
+    static constexpr string _as_string(const T& str)
+    {
+        if constexpr (std::is_convertible_v<const T&, const char_type*>)
+            return string(str);
+        else
+            return string(str.data(), str.size());
+    }
+
+    template <typename Iterator>
+    void _build(Iterator begin, Iterator end)
+    {
+        struct key
+        {
+            string        str;
+            std::uint32_t id;
+        };
+        // The keys [first, last) share the prefix that leads to node.
+        struct work_item
+        {
+            std::uint32_t node;
+            std::size_t   first, last;
+            std::size_t   depth; // in bytes
+        };
+
+        auto key_count = std::size_t(0);
+        auto max_items = std::size_t(1);
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            ++key_count;
+            max_items += _as_string(*iter).size() * _bytes_per_char;
+        }
+        LEXY_PRECONDITION(key_count < _no_id);
+
+        // We need twice the number of keys for sorting.
+        auto keys_size = 2 * key_count * sizeof(key);
+        auto keys      = static_cast<key*>(_resource->allocate(keys_size, alignof(key)));
+        auto scratch   = keys + key_count;
+        {
+            auto id = std::uint32_t(0);
+            for (auto iter = begin; iter != end; ++iter, ++id)
+                keys[id] = key{_as_string(*iter), id};
+        }
+
+        auto items_size = max_items * sizeof(work_item);
+        auto items = static_cast<work_item*>(_resource->allocate(items_size, alignof(work_item)));
+
+        // The root is node zero; no other node can be placed there as all bases are non-zero.
+        // Its check must not match any node, or a childless root would be its own child.
+        _reserve(256 + 1);
+        _nodes[0].check = _no_node - 1;
+
+        // Bucket zero contains all keys that end at the current depth.
+        auto bucket_of = [](const key& k, std::size_t depth) {
+            if (k.str.size() * _bytes_per_char == depth)
+                return 0u;
+
+            auto c = k.str[depth / _bytes_per_char];
+            return 1u + _byte(c, _bytes_per_char - 1 - depth % _bytes_per_char);
+        };
+
+        auto first_free = std::size_t(1);
+        auto item_count = std::size_t(0);
+        items[item_count++] = work_item{0, 0, key_count, 0};
+        while (item_count > 0)
+        {
+            auto item = items[--item_count];
+
+            // Stable counting sort of the keys by their byte at the current depth.
+            std::size_t offsets[1 + 256 + 1] = {};
+            for (auto i = item.first; i != item.last; ++i)
+                ++offsets[bucket_of(keys[i], item.depth) + 1];
+            for (auto b = 1u; b != 1 + 256 + 1; ++b)
+                offsets[b] += offsets[b - 1];
+            for (auto i = item.first; i != item.last; ++i)
+            {
+                auto bucket = bucket_of(keys[i], item.depth);
+                scratch[item.first + offsets[bucket]++] = keys[i];
+            }
+            std::memcpy(keys + item.first, scratch + item.first,
+                        (item.last - item.first) * sizeof(key));
+            // offsets[b] is now the end of bucket b, and thus the beginning of bucket b + 1.
+
+            if (offsets[0] > 0)
+            {
+                // As sorting is stable, the first key has the smallest id.
+                _nodes[item.node].id = keys[item.first].id;
+                ++_size;
+            }
+            if (offsets[0] == item.last - item.first)
+                continue; // No children.
+
+            // Find the lowest base where all children fit.
+            auto min_byte = 0u;
+            while (offsets[min_byte + 1] == offsets[min_byte])
+                ++min_byte;
+
+            auto base = first_free > min_byte ? first_free - min_byte : 1;
+            for (;; ++base)
+            {
+                // Every node needs 256 slots after its base.
+                _reserve(base + 256 + 256);
+
+                auto fits = true;
+                for (auto b = min_byte; b != 256 && fits; ++b)
+                    if (offsets[b + 1] != offsets[b] && _nodes[base + b].check != _no_node)
+                        fits = false;
+                if (fits)
+                    break;
+            }
+
+            // Place the children and queue them.
+            _nodes[item.node].base = std::uint32_t(base);
+            for (auto b = min_byte; b != 256; ++b)
+            {
+                auto first = item.first + offsets[b];
+                auto last  = item.first + offsets[b + 1];
+                if (first == last)
+                    continue;
+
+                auto child          = std::uint32_t(base + b);
+                _nodes[child].check = item.node;
+                items[item_count++] = work_item{child, first, last, item.depth + 1};
+            }
+
+            while (_nodes[first_free].check != _no_node)
+                ++first_free;
+        }
+
+        _resource->deallocate(items, items_size, alignof(work_item));
+        _resource->deallocate(keys, keys_size, alignof(key));
+    }
+
+    LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
+    _node*                                                          _nodes;
+    std::size_t                                                     _capacity;
+    std::size_t                                                     _size;
+};
+} // namespace lexy
+
+namespace lexy
+{
+struct unknown_symbol
+{
+    static LEXY_CONSTEVAL auto name()
+    {
+        return "unknown symbol";
+    }
+};
+} // namespace lexy
+
+namespace lexyd
+{
+template <auto Fn, typename Token>
+struct _sym : rule_base
+{
+    template <typename NextParser>
+    struct parser
+    {
+        template <typename Context, typename Reader, typename... Args>
+        LEXY_DSL_FUNC auto parse(Context& context, Reader& reader, Args&&... args) ->
+            typename Context::result_type
+        {
+            using continuation = lexy::whitespace_parser<Context, NextParser>;
+
+            auto& handler   = context.handler();
+            using handler_t = std::remove_reference_t<decltype(handler)>;
+
+            auto begin = reader.cur();
+            if constexpr (lexy::_is_parse_handler<handler_t>)
+            {
+                using state_type = decltype(handler._state);
+                static_assert(!std::is_same_v<state_type, lexy::_no_parse_state>,
+                              "lexy::dsl::parse_state_symbol requires passing a state to "
+                              "lexy::parse()");
+                const auto& table = lexy::_detail::invoke(Fn, handler._state);
+
+                std::size_t id;
+                if constexpr (std::is_void_v<Token>)
+                {
+                    id = table.match(reader);
+                }
+                else
+                {
+                    using engine = typename Token::token_engine;
+                    if (auto ec = engine::match(reader); ec != typename engine::error_code())
+                        return Token::token_error(context, reader, ec, begin);
+                    id = table.lookup(begin, reader.cur());
+                }
+
+                if (id == table.npos)
+                {
+                    auto err = lexy::make_error<Reader, lexy::unknown_symbol>(begin, reader.cur());
+                    return LEXY_MOV(context).error(err);
+                }
+
+                return continuation::parse(context, reader, LEXY_FWD(args)..., id);
+            }
+            else
+            {
+                static_assert(!std::is_void_v<Token>,
+                              "lexy::dsl::parse_state_symbol without a token requires "
+                              "lexy::parse()");
+
+                // Not used with parse, we can only check the token.
+                using engine = typename Token::token_engine;
+                if (auto ec = engine::match(reader); ec != typename engine::error_code())
+                    return Token::token_error(context, reader, ec, begin);
+                return continuation::parse(context, reader, LEXY_FWD(args)...);
+            }
+        }
+    };
+
+    /// Matches the token first and looks up its lexeme in the symbol table.
+    template <typename T>
+    LEXY_CONSTEVAL auto operator()(T) const
+    {
+        static_assert(std::is_void_v<Token>, "token already specified");
+        static_assert(lexy::is_token<T>);
+        return _sym<Fn, T>{};
+    }
+};
+
+/// Matches the longest string of the `lexy::symbol_table` that is a member of the parsing state,
+/// and produces its id.
+template <auto Fn>
+constexpr auto parse_state_symbol = _sym<Fn, void>{};
+} // namespace lexyd
+
+#endif // LEXY_SYMBOL_TABLE_HPP_INCLUDED
@@ -0,0 +1,307 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_TOKENIZE_HPP_INCLUDED
+#define LEXY_TOKENIZE_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/dsl/base.hpp>
+#include <lexy/engine/base.hpp>
+#include <lexy/engine/dfa.hpp>
+#include <lexy/input/base.hpp>
+
+namespace lexy
+{
+/// A sequence of tokens stored as structure of arrays:
+/// the kind, the offset from the beginning of the input and the length of each token.
+template <typename MemoryResource = _detail::default_memory_resource>
+class token_stream
+{
+public:
+    using kind_type = std::uint16_t;
+
+    /// The kind of code units that aren't matched by any token.
+    static constexpr kind_type error_kind = kind_type(-1);
+
+    //=== constructors ===//
+    constexpr token_stream() noexcept : token_stream(_detail::get_memory_resource<MemoryResource>())
+    {}
+
+    constexpr explicit token_stream(MemoryResource* resource) noexcept
+    : _resource(resource), _memory(nullptr), _size(0), _capacity(0)
+    {}
+
+    token_stream(const token_stream& other) : token_stream(other, other._resource.get()) {}
+    token_stream(const token_stream& other, MemoryResource* resource) : token_stream(resource)
+    {
+        if (other._size == 0)
+            return;
+
+        reserve(other._size);
+        std::memcpy(_offsets(), other._offsets(), other._size * sizeof(std::uint32_t));
+        std::memcpy(_lengths(), other._lengths(), other._size * sizeof(std::uint32_t));
+        std::memcpy(_kinds(), other._kinds(), other._size * sizeof(kind_type));
+        _size = other._size;
+    }
+
+    token_stream(token_stream&& other) noexcept
+    : _resource(other._resource), _memory(other._memory), _size(other._size),
+      _capacity(other._capacity)
+    {
+        other._memory   = nullptr;
+        other._size     = 0;
+        other._capacity = 0;
+    }
+
+    ~token_stream() noexcept
+    {
+        if (_memory)
+            _resource->deallocate(_memory, _capacity * _bytes_per_token, alignof(std::uint32_t));
+    }
+
+    token_stream& operator=(const token_stream& other)
+    {
+        return *this = token_stream(other, _resource.get());
+    }
+
+    token_stream& operator=(token_stream&& other) noexcept(std::is_empty_v<MemoryResource>)
+    {
+        if (*_resource == *other._resource)
+        {
+            _detail::swap(_memory, other._memory);
+            _detail::swap(_size, other._size);
+            _detail::swap(_capacity, other._capacity);
+            return *this;
+        }
+        else
+        {
+            LEXY_PRECONDITION(!std::is_empty_v<MemoryResource>);
+
+            token_stream copy(other, _resource.get());
+            _detail::swap(_memory, copy._memory);
+            _detail::swap(_size, copy._size);
+            _detail::swap(_capacity, copy._capacity);
+            return *this;
+        }
+    }
+
+    //=== access ===//
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /// The arrays containing the kind, offset and length of each token.
+    const kind_type* kinds() const noexcept
+    {
+        return _kinds();
+    }
+    const std::uint32_t* offsets() const noexcept
+    {
+        return _offsets();
+    }
+    const std::uint32_t* lengths() const noexcept
+    {
+        return _lengths();
+    }
+
+    kind_type kind(std::size_t idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _kinds()[idx];
+    }
+    std::uint32_t offset(std::size_t idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _offsets()[idx];
+    }
+    std::uint32_t length(std::size_t idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx < _size);
+        return _lengths()[idx];
+    }
+
+    //=== modifiers ===//
+    void reserve(std::size_t capacity)
+    {
+        if (capacity <= _capacity)
+            return;
+
+        auto memory = static_cast<unsigned char*>(
+            _resource->allocate(capacity * _bytes_per_token, alignof(std::uint32_t)));
+        if (_memory)
+        {
+            std::memcpy(memory, _offsets(), _size * sizeof(std::uint32_t));
+            std::memcpy(memory + capacity * sizeof(std::uint32_t), _lengths(),
+                        _size * sizeof(std::uint32_t));
+            std::memcpy(memory + capacity * 2 * sizeof(std::uint32_t), _kinds(),
+                        _size * sizeof(kind_type));
+            _resource->deallocate(_memory, _capacity * _bytes_per_token, alignof(std::uint32_t));
+        }
+
+        _memory   = memory;
+        _capacity = capacity;
+    }
+
+    void push_back(kind_type kind, std::uint32_t offset, std::uint32_t length)
+    {
+        if (_size == _capacity)
+            reserve(_capacity == 0 ? std::size_t(256) : 2 * _capacity);
+
+        _offsets()[_size] = offset;
+        _lengths()[_size] = length;
+        _kinds()[_size]   = kind;
+        ++_size;
+    }
+
+    /// Removes all tokens starting with the given one, e.g. to relex the rest of the input.
+    void truncate(std::size_t size) noexcept
+    {
+        LEXY_PRECONDITION(size <= _size);
+        _size = size;
+    }
+
+    void clear() noexcept
+    {
+        _size = 0;
+    }
+
+private:
+    static constexpr auto _bytes_per_token = 2 * sizeof(std::uint32_t) + sizeof(kind_type);
+
+    // The memory contains `_capacity` offsets, followed by the lengths, followed by the kinds.
+    std::uint32_t* _offsets() const noexcept
+    {
+        return reinterpret_cast<std::uint32_t*>(_memory);
+    }
+    std::uint32_t* _lengths() const noexcept
+    {
+        return reinterpret_cast<std::uint32_t*>(_memory + _capacity * sizeof(std::uint32_t));
+    }
+    kind_type* _kinds() const noexcept
+    {
+        return reinterpret_cast<kind_type*>(_memory + _capacity * 2 * sizeof(std::uint32_t));
+    }
+
+    LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
+    unsigned char*                                                 _memory;
+    std::size_t                                                    _size, _capacity;
+};
+} // namespace lexy
+
+namespace lexy
+{
+// Matches the token, advancing the reader on success.
+template <typename Token, typename Reader>
+constexpr bool _token_try_match(Reader& reader)
+{
+    using engine = _fused_engine<typename Token::token_engine, typename Reader::encoding>;
+    return lexy::engine_try_match<engine>(reader);
+}
+
+/// Splits the input into the tokens and appends them to the stream.
+/// The kind of each token is the index of the first token that has the longest match at that
+/// position; consecutive code units that aren't matched by any token are one token of
+/// `error_kind`.
+/// Returns `false` if the input is longer than 4 GiB, after appending the tokens before that.
+template <typename MemoryResource, typename Input, typename... Tokens>
+bool tokenize_into(token_stream<MemoryResource>& stream, const Input& input, Tokens...)
+{
+    static_assert(sizeof...(Tokens) > 0 && (lexy::is_token<Tokens> && ...),
+                  "tokenize() requires tokens");
+    static_assert(sizeof...(Tokens) < token_stream<MemoryResource>::error_kind,
+                  "too many tokens");
+    using kind_type = typename token_stream<MemoryResource>::kind_type;
+
+    // The offsets and lengths are stored as 32 bit integers, so a token must end before that.
+    constexpr auto max_end = std::size_t(std::uint32_t(-1));
+
+    auto reader = input.reader();
+    auto begin  = reader.cur();
+
+    auto error_begin = begin;
+    auto in_error    = false;
+    auto flush_error = [&] {
+        if (!in_error)
+            return true;
+
+        auto offset = _detail::range_size(begin, error_begin);
+        auto length = _detail::range_size(error_begin, reader.cur());
+        if (offset + length > max_end)
+            return false;
+
+        stream.push_back(token_stream<MemoryResource>::error_kind, std::uint32_t(offset),
+                         std::uint32_t(length));
+        in_error = false;
+        return true;
+    };
+
+    while (!reader.eof())
+    {
+        // Find the longest match, the first token wins ties.
+        auto best_kind   = std::size_t(0);
+        auto best_length = std::size_t(0);
+        auto best_end    = reader;
+        auto kind        = std::size_t(0);
+        (void)((([&] {
+                    auto copy = reader;
+                    if (_token_try_match<Tokens>(copy))
+                    {
+                        auto length = _detail::range_size(reader.cur(), copy.cur());
+                        if (length > best_length)
+                        {
+                            best_kind   = kind;
+                            best_length = length;
+                            best_end    = LEXY_MOV(copy);
+                        }
+                    }
+                    ++kind;
+                }()),
+                ...));
+
+        if (best_length == 0)
+        {
+            // No token matches (or only with an empty match), so it's an error.
+            if (!in_error)
+            {
+                error_begin = reader.cur();
+                in_error    = true;
+            }
+            reader.bump();
+            continue;
+        }
+        else if (!flush_error())
+            return false;
+
+        auto offset = _detail::range_size(begin, reader.cur());
+        if (offset + best_length > max_end)
+            return false;
+        stream.push_back(kind_type(best_kind), std::uint32_t(offset), std::uint32_t(best_length));
+
+        // We continue after the token that was matched.
+        reader = LEXY_MOV(best_end);
+    }
+    return flush_error();
+}
+
+/// Splits the input into the tokens, see `tokenize_into()`.
+/// The input must not be longer than 4 GiB.
+template <typename Input, typename... Tokens>
+auto tokenize(const Input& input, Tokens... tokens)
+{
+    token_stream<> stream;
+    [[maybe_unused]] auto complete = tokenize_into(stream, input, tokens...);
+    LEXY_PRECONDITION(complete);
+    return stream;
+}
+} // namespace lexy
+
+#endif // LEXY_TOKENIZE_HPP_INCLUDED
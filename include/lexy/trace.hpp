@@ -0,0 +1,338 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#ifndef LEXY_TRACE_HPP_INCLUDED
+#define LEXY_TRACE_HPP_INCLUDED
+
+#include <chrono>
+#include <cstdio>
+#include <lexy/input/base.hpp>
+#include <lexy/parse.hpp>
+#include <lexy/validate.hpp>
+#include <vector>
+
+namespace lexy
+{
+/// Collects per-production statistics of `lexy::trace_parse()` and `lexy::trace_validate()`.
+class trace_profile
+{
+public:
+    using clock    = std::chrono::steady_clock;
+    using duration = clock::duration;
+
+    struct production_stats
+    {
+        _detail::string_view name;
+        /// The number of times the production was parsed.
+        std::size_t count;
+        /// The number of times the production failed, either directly or because a child failed.
+        std::size_t failures;
+        /// The number of code units consumed by successful parses.
+        std::size_t bytes;
+        /// The time spent in the production, including and excluding its child productions.
+        duration inclusive, exclusive;
+    };
+
+    trace_profile() : _nodes{_node{}} {}
+
+    /// Returns the statistics of each production, in the order they were first parsed.
+    std::vector<production_stats> productions() const
+    {
+        std::vector<production_stats> result;
+        for (auto& prod : _productions)
+            result.push_back({prod.name, 0, 0, 0, {}, {}});
+
+        for (auto idx = std::size_t(1); idx < _nodes.size(); ++idx)
+        {
+            auto& node  = _nodes[idx];
+            auto& stats = result[node.production];
+            stats.count += node.count;
+            stats.failures += node.failures;
+            stats.bytes += node.bytes;
+            stats.exclusive += node.inclusive - node.children;
+
+            // For recursive productions, only the outermost invocation contributes its inclusive
+            // time; the others are already part of it.
+            auto recursive = false;
+            for (auto parent = node.parent; parent != 0 && !recursive;
+                 parent      = _nodes[parent].parent)
+                recursive = _nodes[parent].production == node.production;
+            if (!recursive)
+                stats.inclusive += node.inclusive;
+        }
+
+        return result;
+    }
+
+    /// Writes the exclusive time in nanoseconds of each production stack,
+    /// in the folded format used by flamegraph tools.
+    void write_folded(std::FILE* file) const
+    {
+        for (auto idx = std::size_t(1); idx < _nodes.size(); ++idx)
+        {
+            auto& node = _nodes[idx];
+            auto  ns   = _ns(node.inclusive - node.children);
+            if (ns == 0)
+                continue;
+
+            _write_stack(file, idx);
+            std::fprintf(file, " %llu\n", ns);
+        }
+    }
+
+    /// Writes the statistics of each production as a JSON array.
+    void write_json(std::FILE* file) const
+    {
+        std::fputs("[", file);
+
+        auto first = true;
+        for (auto& stats : productions())
+        {
+            std::fputs(first ? "\n  {\"name\": \"" : ",\n  {\"name\": \"", file);
+            for (auto c : stats.name)
+            {
+                if (c == '"' || c == '\\')
+                    std::fputc('\\', file);
+                std::fputc(c, file);
+            }
+            std::fprintf(file,
+                         "\", \"count\": %zu, \"failures\": %zu, \"bytes\": %zu, "
+                         "\"inclusive_ns\": %llu, \"exclusive_ns\": %llu}",
+                         stats.count, stats.failures, stats.bytes, _ns(stats.inclusive),
+                         _ns(stats.exclusive));
+            first = false;
+        }
+
+        std::fputs("\n]\n", file);
+    }
+
+    /// Discards all collected statistics.
+    void clear()
+    {
+        _productions.clear();
+        _nodes.resize(1);
+        _nodes[0] = _node{};
+        _active.clear();
+    }
+
+private:
+    struct _production
+    {
+        const void*          id;
+        _detail::string_view name;
+    };
+
+    // A node in the call tree, i.e. a production together with the stack of its parents.
+    // Node zero is a virtual root.
+    struct _node
+    {
+        std::size_t production   = 0;
+        std::size_t parent       = 0;
+        std::size_t first_child  = 0;
+        std::size_t next_sibling = 0;
+
+        std::size_t count    = 0;
+        std::size_t failures = 0;
+        std::size_t bytes    = 0;
+        duration    inclusive{};
+        duration    children{};
+    };
+
+    struct _active_node
+    {
+        std::size_t       node;
+        clock::time_point start;
+    };
+
+    static unsigned long long _ns(duration d)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        return ns < 0 ? 0 : static_cast<unsigned long long>(ns);
+    }
+
+    void _write_stack(std::FILE* file, std::size_t idx) const
+    {
+        auto parent = _nodes[idx].parent;
+        if (parent != 0)
+        {
+            _write_stack(file, parent);
+            std::fputc(';', file);
+        }
+
+        // Semicolons separate the frames, so we can't have them in names.
+        for (auto c : _productions[_nodes[idx].production].name)
+            std::fputc(c == ';' ? ':' : c, file);
+    }
+
+    std::size_t _production_index(const void* id, _detail::string_view name)
+    {
+        for (auto idx = std::size_t(0); idx != _productions.size(); ++idx)
+            if (_productions[idx].id == id)
+                return idx;
+
+        _productions.push_back({id, name});
+        return _productions.size() - 1;
+    }
+
+    void _enter(const void* id, _detail::string_view name)
+    {
+        auto parent     = _active.empty() ? std::size_t(0) : _active.back().node;
+        auto production = _production_index(id, name);
+
+        auto node = _nodes[parent].first_child;
+        while (node != 0 && _nodes[node].production != production)
+            node = _nodes[node].next_sibling;
+        if (node == 0)
+        {
+            node = _nodes.size();
+
+            auto& n        = _nodes.emplace_back();
+            n.production   = production;
+            n.parent       = parent;
+            n.next_sibling = _nodes[parent].first_child;
+
+            _nodes[parent].first_child = node;
+        }
+
+        ++_nodes[node].count;
+        // Start the clock last, so our overhead isn't counted.
+        _active.push_back({node, clock::now()});
+    }
+
+    void _exit(bool success, std::size_t bytes)
+    {
+        auto end    = clock::now();
+        auto active = _active.back();
+        _active.pop_back();
+
+        auto& node = _nodes[active.node];
+        if (success)
+            node.bytes += bytes;
+        else
+            ++node.failures;
+
+        auto time = end - active.start;
+        node.inclusive += time;
+        _nodes[node.parent].children += time;
+    }
+
+    // After an error, the parents of the failed production aren't finished.
+    void _unwind()
+    {
+        while (!_active.empty())
+            _exit(false, 0);
+    }
+
+    std::vector<_production>  _productions;
+    std::vector<_node>        _nodes;
+    std::vector<_active_node> _active;
+
+    template <typename Handler, typename Reader>
+    friend struct _trace_handler;
+};
+
+template <typename Production>
+inline constexpr char _trace_id = 0;
+
+template <typename Handler, typename Reader>
+struct _trace_handler : Handler
+{
+    trace_profile* _profile;
+    const Reader*  _reader;
+
+    template <typename State>
+    struct _state_t
+    {
+        State                     state;
+        typename Reader::iterator begin;
+    };
+
+    template <typename Production, typename Iterator>
+    auto start_production(Production p, Iterator pos)
+    {
+        constexpr auto name = lexy::production_name<Production>();
+        _profile->_enter(&_trace_id<Production>, name);
+
+        using state = decltype(Handler::start_production(p, pos));
+        return _state_t<state>{Handler::start_production(p, pos), pos};
+    }
+
+    template <typename Production, typename State, typename... Args>
+    auto finish_production(Production p, State&& state, Args&&... args)
+    {
+        auto result = Handler::finish_production(p, LEXY_MOV(state.state), LEXY_FWD(args)...);
+
+        // Productions inside `dsl::encode` are parsed on a different reader,
+        // so our reader might be behind.
+        auto end   = _reader->cur();
+        auto bytes = std::size_t(0);
+        if constexpr (std::is_pointer_v<typename Reader::iterator>)
+            bytes = state.begin <= end ? std::size_t(end - state.begin) : 0;
+        else
+            bytes = _detail::range_size(state.begin, end);
+
+        _profile->_exit(true, bytes);
+        return result;
+    }
+
+    template <typename Production, typename State, typename Error>
+    auto error(Production p, State&& state, Error&& error)
+    {
+        _profile->_exit(false, 0);
+        return Handler::error(p, LEXY_MOV(state.state), LEXY_FWD(error));
+    }
+
+    void _finish_parse()
+    {
+        _profile->_unwind();
+    }
+};
+
+template <typename Handler, typename Reader>
+constexpr bool _is_parse_handler<_trace_handler<Handler, Reader>> = _is_parse_handler<Handler>;
+template <typename Handler, typename Reader>
+constexpr bool _handler_discards_values<_trace_handler<Handler, Reader>>
+    = _handler_discards_values<Handler>;
+
+template <typename Production, typename Handler, typename Reader>
+auto _trace(trace_profile& profile, Handler&& handler, Reader& reader)
+{
+    using handler_t    = _trace_handler<std::decay_t<Handler>, Reader>;
+    auto trace_handler = handler_t{LEXY_MOV(handler), &profile, &reader};
+
+    lexy::parse_context context(Production{}, trace_handler, reader.cur());
+
+    using rule  = lexy::production_rule<Production>;
+    auto result = lexy::rule_parser<rule, lexy::context_value_parser>::parse(context, reader);
+    trace_handler._finish_parse();
+    return result;
+}
+
+/// Parses the production like `lexy::parse()`, recording statistics about each production.
+template <typename Production, typename Input, typename State, typename Callback>
+auto trace_parse(trace_profile& profile, const Input& input, State&& state, Callback callback)
+{
+    using handler_t = _parse_handler<Input, std::decay_t<State>, Callback>;
+
+    auto reader = input.reader();
+    return _trace<Production>(profile, handler_t{&input, state, LEXY_MOV(callback)}, reader);
+}
+template <typename Production, typename Input, typename Callback>
+auto trace_parse(trace_profile& profile, const Input& input, Callback callback)
+{
+    return trace_parse<Production>(profile, input, _no_parse_state{}, callback);
+}
+
+/// Validates the production like `lexy::validate()`, recording statistics about each production.
+template <typename Production, typename Input, typename Callback>
+auto trace_validate(trace_profile& profile, const Input& input, Callback callback)
+{
+    using handler_t = _validate_handler<Input, Callback>;
+
+    auto reader = input.reader();
+    return _trace<Production>(profile, handler_t{&input, LEXY_MOV(callback)}, reader);
+}
+} // namespace lexy
+
+#endif // LEXY_TRACE_HPP_INCLUDED
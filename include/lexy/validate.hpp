@@ -48,6 +48,9 @@ struct _validate_handler
     }
 };
 
+template <typename Input, typename Callback>
+constexpr bool _handler_discards_values<_validate_handler<Input, Callback>> = true;
+
 template <typename Production, typename Input, typename Callback>
 constexpr auto validate(const Input& input, Callback callback)
 {
@@ -6,6 +6,7 @@
 
 #include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <lexy/_detail/buffer_builder.hpp>
 
 namespace
@@ -50,15 +51,9 @@ lexy::file_error get_file_error() noexcept
         return lexy::file_error::os_error;
     }
 }
-} // namespace
 
-lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, void* user_data)
+lexy::file_error read_all(std::FILE* file, lexy::_detail::buffer_builder<char>& buffer)
 {
-    file_handle file(std::fopen(path, "rb"));
-    if (!file)
-        return get_file_error();
-
-    _detail::buffer_builder<char> buffer;
     while (true)
     {
         const auto buffer_size = buffer.write_size();
@@ -74,11 +69,11 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
         {
             if (std::ferror(file))
                 // We have a read error.
-                return file_error::os_error;
+                return lexy::file_error::os_error;
 
             // We should have reached the end of the file.
             LEXY_ASSERT(std::feof(file), "why did fread() not read enough?");
-            break;
+            return lexy::file_error::_success;
         }
 
         // We've filled the entire buffer and need more space.
@@ -86,8 +81,70 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
         // input, but checking this requires reading more input.
         buffer.grow();
     }
+}
 
-    cb(user_data, buffer.read_data(), buffer.read_size());
-    return file_error::_success;
+// Appends the data to the buffer, leaving room for reading more.
+void append(lexy::_detail::buffer_builder<char>& buffer, const char* data, std::size_t size)
+{
+    while (buffer.write_size() <= size)
+        buffer.grow();
+
+    std::memcpy(buffer.write_data(), data, size);
+    buffer.commit(size);
 }
 
+// Returns the size of a regular file, or -1 if it can't be determined up front (e.g. a pipe).
+std::size_t get_file_size(std::FILE* file) noexcept
+{
+    if (std::fseek(file, 0, SEEK_END) != 0)
+        return std::size_t(-1);
+
+    auto size = std::ftell(file);
+    if (size < 0 || std::fseek(file, 0, SEEK_SET) != 0)
+    {
+        std::clearerr(file);
+        return std::size_t(-1);
+    }
+
+    return std::size_t(size);
+}
+} // namespace
+
+lexy::file_error lexy::_detail::read_file_into(const char* path, file_allocate_callback allocate,
+                                               void* user_data)
+{
+    file_handle file(std::fopen(path, "rb"));
+    if (!file)
+        return get_file_error();
+
+    _detail::buffer_builder<char> buffer;
+    if (auto size = get_file_size(file); size != std::size_t(-1))
+    {
+        // We assume the size is right, so we can read directly into the final memory.
+        auto memory = static_cast<char*>(allocate(user_data, size));
+        auto read   = std::fread(memory, sizeof(char), size, file);
+        if (read == size)
+        {
+            // Check that the file didn't grow.
+            auto c = std::fgetc(file);
+            if (c == EOF)
+                return std::ferror(file) ? file_error::os_error : file_error::_success;
+
+            std::ungetc(c, file);
+        }
+        else if (std::ferror(file))
+            return file_error::os_error;
+
+        // The size was only a hint, e.g. files in /sys report 4096 bytes.
+        // We continue with a temporary buffer like for files without a size.
+        append(buffer, memory, read);
+    }
+
+    // We need to read into a temporary buffer first.
+    if (auto error = read_all(file, buffer); error != file_error::_success)
+        return error;
+
+    auto memory = allocate(user_data, buffer.read_size());
+    std::memcpy(memory, buffer.read_data(), buffer.read_size());
+    return file_error::_success;
+}
@@ -0,0 +1,32 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/_detail/simd.hpp>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("host_simd_level")
+{
+    using lexy::_detail::simd_level;
+
+    auto level = lexy::_detail::host_simd_level();
+    CHECK(level == lexy::_detail::host_simd_level());
+#if defined(LEXY_FORCE_SIMD_LEVEL)
+    // The forced level is only used if the CPU supports it.
+    auto detected = lexy::_detail::detect_simd_level();
+    if (simd_level::LEXY_FORCE_SIMD_LEVEL <= detected)
+        CHECK(level == simd_level::LEXY_FORCE_SIMD_LEVEL);
+    else
+        CHECK(level == detected);
+#else
+    // The CPU supports at least the instruction sets the compiler targets.
+#    if defined(__AVX2__)
+    CHECK(level >= simd_level::avx2);
+#    endif
+#    if LEXY_HAS_SSE2
+    CHECK(level >= simd_level::sse2);
+#    endif
+    CHECK(lexy::_detail::detect_simd_level() == level);
+#endif
+}
@@ -4,6 +4,9 @@
 
 #include <lexy/dsl/encode.hpp>
 
+#include <lexy/dsl/alternative.hpp>
+#include <lexy/dsl/while.hpp>
+
 // Maybe because of this issue here?
 // I don't know, in either case - just disable it.
 // https://developercommunity2.visualstudio.com/t/cl-fails-when-copy-initializing-variable/1277587
@@ -159,5 +162,33 @@ TEST_CASE("dsl::encoded")
         auto bom_big = LEXY_VERIFY_ENCODING(lexy::raw_encoding, input_big, 8);
         CHECK(bom_big == 8);
     }
+    SUBCASE("backtracking")
+    {
+        // "ababab...abc" in UTF-16BE.
+        struct input_t
+        {
+            unsigned char data[2 * 201];
+
+            constexpr input_t() : data{}
+            {
+                for (auto i = 0; i != 200; ++i)
+                    data[2 * i + 1] = i % 2 == 0 ? 'a' : 'b';
+                data[2 * 200 + 1] = 'c';
+            }
+        };
+        static constexpr auto input = input_t{};
+
+        static constexpr auto encode
+            = lexy::dsl::encode<lexy::utf16_encoding, lexy::encoding_endianness::big>;
+        // The alternative needs to backtrack at the final "c".
+        static constexpr auto rule
+            = encode(lexy::dsl::while_(LEXY_LIT(u"ab") / LEXY_LIT(u"ac")) + LEXY_LIT(u"c"));
+        CHECK(lexy::is_rule<decltype(rule)>);
+
+        auto partial = LEXY_VERIFY_ENCODING(lexy::raw_encoding, input.data, 2 * 200);
+        CHECK(partial == -1);
+        auto full = LEXY_VERIFY_ENCODING(lexy::raw_encoding, input.data, 2 * 201);
+        CHECK(full == 2 * 201);
+    }
 }
 
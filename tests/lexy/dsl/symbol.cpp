@@ -0,0 +1,95 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/symbol_table.hpp>
+
+#include "verify.hpp"
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/token.hpp>
+#include <lexy/dsl/while.hpp>
+#include <lexy/validate.hpp>
+
+namespace parse_state_symbol
+{
+struct state
+{
+    lexy::symbol_table<> fields;
+};
+
+struct production
+{
+    static constexpr auto rule  = lexy::dsl::parse_state_symbol<&state::fields>;
+    static constexpr auto value = lexy::forward<std::size_t>;
+};
+
+struct token_production
+{
+    static constexpr auto rule = lexy::dsl::parse_state_symbol<&state::fields>(
+        lexy::dsl::token(lexy::dsl::while_one(lexy::dsl::ascii::alpha)));
+    static constexpr auto value = lexy::forward<std::size_t>;
+};
+
+struct callback
+{
+    using return_type = int;
+
+    template <typename Production>
+    int operator()(const lexy::error_context<Production, lexy::string_input<>>& context,
+                   const lexy::error_for<lexy::string_input<>, lexy::unknown_symbol>& error)
+    {
+        CHECK(error.begin() == context.input().begin());
+        return int(error.end() - error.begin());
+    }
+    template <typename Production, typename Error>
+    int operator()(const lexy::error_context<Production, lexy::string_input<>>&, const Error&)
+    {
+        return -1;
+    }
+};
+} // namespace parse_state_symbol
+
+TEST_CASE("rule: parse_state_symbol")
+{
+    using namespace parse_state_symbol;
+
+    state s{lexy::symbol_table<>{"id", "name", "namespace"}};
+
+    SUBCASE("longest match")
+    {
+        auto id = lexy::parse<production>(lexy::zstring_input("id"), s, callback{});
+        CHECK(id);
+        CHECK(id.value() == 0);
+
+        auto name = lexy::parse<production>(lexy::zstring_input("names"), s, callback{});
+        CHECK(name);
+        CHECK(name.value() == 1);
+
+        auto ns = lexy::parse<production>(lexy::zstring_input("namespace"), s, callback{});
+        CHECK(ns);
+        CHECK(ns.value() == 2);
+
+        auto unknown = lexy::parse<production>(lexy::zstring_input("nam"), s, callback{});
+        CHECK(!unknown);
+        CHECK(unknown.error() == 0);
+    }
+    SUBCASE("token")
+    {
+        auto name = lexy::parse<token_production>(lexy::zstring_input("name"), s, callback{});
+        CHECK(name);
+        CHECK(name.value() == 1);
+
+        auto names = lexy::parse<token_production>(lexy::zstring_input("names"), s, callback{});
+        CHECK(!names);
+        CHECK(names.error() == 5);
+
+        auto missing = lexy::parse<token_production>(lexy::zstring_input("123"), s, callback{});
+        CHECK(!missing);
+        CHECK(missing.error() == -1);
+    }
+    SUBCASE("token validate")
+    {
+        CHECK(lexy::validate<token_production>(lexy::zstring_input("names"), callback{}));
+        CHECK(!lexy::validate<token_production>(lexy::zstring_input("123"), callback{}));
+    }
+}
@@ -5,8 +5,54 @@
 #include <lexy/dsl/token.hpp>
 
 #include "verify.hpp"
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/digit.hpp>
 #include <lexy/dsl/list.hpp>
+#include <lexy/dsl/literal.hpp>
 #include <lexy/dsl/value.hpp>
+#include <string>
+
+namespace
+{
+template <typename Token>
+using token_dfa = lexy::_fused_engine<typename Token::token_engine, lexy::default_encoding>;
+
+// Checks that the DFA of the token matches the same input as its rule on all short strings.
+template <typename Token>
+void verify_token_dfa()
+{
+    using engine = typename Token::token_engine;
+    REQUIRE(!std::is_same_v<token_dfa<Token>, engine>);
+
+    const char alphabet[] = {'a', '1', '-', '_'};
+
+    std::string str;
+    auto        check = [&] {
+        INFO(str);
+        auto engine_reader = lexy::zstring_input(str.c_str()).reader();
+        auto dfa_reader    = engine_reader;
+        REQUIRE(lexy::engine_try_match<engine>(engine_reader)
+                == lexy::engine_try_match<token_dfa<Token>>(dfa_reader));
+        REQUIRE(engine_reader.cur() == dfa_reader.cur());
+    };
+
+    check();
+    for (auto length = 1u; length <= 4; ++length)
+    {
+        auto count = 1u;
+        for (auto i = 0u; i != length; ++i)
+            count *= sizeof(alphabet);
+
+        for (auto n = 0u; n != count; ++n)
+        {
+            str.clear();
+            for (auto digit = n, i = 0u; i != length; ++i, digit /= sizeof(alphabet))
+                str.push_back(alphabet[digit % sizeof(alphabet)]);
+            check();
+        }
+    }
+}
+} // namespace
 
 TEST_CASE("dsl::token")
 {
@@ -41,3 +87,36 @@ TEST_CASE("dsl::token")
     CHECK(three == 9);
 }
 
+
+TEST_CASE("dsl::token dfa")
+{
+    using namespace lexy::dsl;
+
+    SUBCASE("identifier")
+    {
+        constexpr auto id = token(ascii::alpha + while_(ascii::alnum));
+        verify_token_dfa<decltype(id)>();
+
+        constexpr auto id_one = token(while_one(ascii::alnum));
+        verify_token_dfa<decltype(id_one)>();
+    }
+    SUBCASE("number")
+    {
+        constexpr auto number = token(opt(lit_c<'-'>) + digits<>);
+        verify_token_dfa<decltype(number)>();
+
+        constexpr auto number_one = token(opt(lit_c<'-'>) + while_one(digit<>));
+        verify_token_dfa<decltype(number_one)>();
+    }
+    SUBCASE("not regular")
+    {
+        constexpr auto list_rule = token(list(lit_c<'a'>));
+        CHECK(std::is_same_v<token_dfa<decltype(list_rule)>,
+                             typename decltype(list_rule)::token_engine>);
+
+        // The rule doesn't backtrack into the optional literal, so the DFA can't be used.
+        constexpr auto opt_prefix = token(opt(LEXY_LIT("a1")) + lit_c<'a'>);
+        CHECK(std::is_same_v<token_dfa<decltype(opt_prefix)>,
+                             typename decltype(opt_prefix)::token_engine>);
+    }
+}
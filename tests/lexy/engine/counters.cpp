@@ -0,0 +1,92 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/engine/counters.hpp>
+
+#include "verify.hpp"
+#include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/literal.hpp>
+#include <lexy/engine/trie.hpp>
+
+static_assert(LEXY_ENABLE_ENGINE_COUNTERS, "counters need to be enabled for this test");
+
+namespace
+{
+constexpr auto trie_abc = lexy::linear_trie<LEXY_NTTP_STRING("abc")>;
+constexpr auto trie_basic
+    = lexy::trie<char, LEXY_NTTP_STRING("ab"), LEXY_NTTP_STRING("abcd"), LEXY_NTTP_STRING("b")>;
+
+template <typename Engine>
+bool try_match(const char* str)
+{
+    auto input  = lexy::zstring_input(str);
+    auto reader = input.reader();
+    return lexy::engine_try_match<Engine>(reader);
+}
+
+template <typename Engine>
+const lexy::engine_counter* find_counter()
+{
+    auto name = lexy::_detail::type_name<Engine>(0);
+
+    const lexy::engine_counter* result = nullptr;
+    lexy::for_each_engine_counter([&](const lexy::engine_counter& counter) {
+        if (counter.name == name)
+            result = &counter;
+    });
+    return result;
+}
+} // namespace
+
+TEST_CASE("engine counters")
+{
+    lexy::reset_engine_counters();
+
+    SUBCASE("engine_literal")
+    {
+        using engine = lexy::engine_literal<trie_abc>;
+
+        CHECK(try_match<engine>("abc"));
+        CHECK(!try_match<engine>("abd"));
+        CHECK(!try_match<engine>("ab"));
+        CHECK(!try_match<engine>("x"));
+
+        auto counter = find_counter<engine>();
+        REQUIRE(counter);
+        CHECK(counter->attempts == 4);
+        CHECK(counter->failures == 3);
+        CHECK(counter->wasted == 2 + 2 + 0);
+        CHECK(counter->partial_failures == 2);
+    }
+    SUBCASE("engine_trie")
+    {
+        using engine = lexy::engine_trie<trie_basic>;
+
+        CHECK(try_match<engine>("abc"));
+        CHECK(!try_match<engine>("a"));
+        CHECK(!try_match<engine>("c"));
+
+        auto counter = find_counter<engine>();
+        REQUIRE(counter);
+        CHECK(counter->attempts == 3);
+        CHECK(counter->failures == 2);
+        CHECK(counter->wasted == 1);
+        CHECK(counter->partial_failures == 1);
+
+        lexy::reset_engine_counters();
+        CHECK(counter->attempts == 0);
+        CHECK(counter->failures == 0);
+    }
+    SUBCASE("constexpr")
+    {
+        using engine = lexy::engine_literal<trie_abc>;
+
+        constexpr auto result = [] {
+            auto input  = lexy::zstring_input("abd");
+            auto reader = input.reader();
+            return lexy::engine_try_match<engine>(reader);
+        }();
+        CHECK(!result);
+    }
+}
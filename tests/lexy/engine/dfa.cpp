@@ -0,0 +1,127 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/engine/dfa.hpp>
+
+#include "verify.hpp"
+#include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/char_class.hpp>
+#include <lexy/engine/digits.hpp>
+#include <lexy/engine/literal.hpp>
+#include <lexy/engine/minus.hpp>
+#include <lexy/engine/trie.hpp>
+#include <lexy/engine/until.hpp>
+#include <lexy/engine/while.hpp>
+#include <string>
+
+namespace
+{
+constexpr auto literal_ab = lexy::linear_trie<LEXY_NTTP_STRING("ab")>;
+constexpr auto literal_e9 = lexy::linear_trie<LEXY_NTTP_STRING("\xE9")>;
+constexpr auto trie_a_bc  = lexy::trie<char, LEXY_NTTP_STRING("a"), LEXY_NTTP_STRING("bc")>;
+constexpr auto trie_a_ab  = lexy::trie<char, LEXY_NTTP_STRING("a"), LEXY_NTTP_STRING("ab")>;
+constexpr auto trie_a_abc = lexy::trie<char, LEXY_NTTP_STRING("a"), LEXY_NTTP_STRING("ab"),
+                                       LEXY_NTTP_STRING("abc")>;
+constexpr auto set_ac     = lexy::_make_strie<LEXY_NTTP_STRING("ac")>();
+
+using encoding = lexy::default_encoding;
+
+// Checks that the DFA matches the same input as the engine on all short strings.
+template <typename Engine>
+void verify_dfa()
+{
+    REQUIRE(lexy::engine_is_regular<Engine, encoding>);
+    using dfa = lexy::engine_dfa<lexy::dfa<Engine, encoding>>;
+
+    const char alphabet[] = {'a', 'b', 'c', '\xE9'};
+
+    std::string str;
+    auto        check = [&] {
+        INFO(str);
+        auto engine_result = engine_matches<Engine>(str.c_str());
+        auto dfa_result    = engine_matches<dfa>(str.c_str());
+        REQUIRE(bool(engine_result) == bool(dfa_result));
+        if (engine_result)
+            REQUIRE(engine_result.count == dfa_result.count);
+    };
+
+    check();
+    for (auto length = 1u; length <= 5; ++length)
+    {
+        auto count = 1u;
+        for (auto i = 0u; i != length; ++i)
+            count *= sizeof(alphabet);
+
+        for (auto n = 0u; n != count; ++n)
+        {
+            str.clear();
+            for (auto digit = n, i = 0u; i != length; ++i, digit /= sizeof(alphabet))
+                str.push_back(alphabet[digit % sizeof(alphabet)]);
+            check();
+        }
+    }
+}
+} // namespace
+
+TEST_CASE("dfa")
+{
+    using char_ab = lexy::engine_char_range<'a', 'b'>;
+    using char_ac = lexy::engine_char_set<set_ac>;
+    using ab      = lexy::engine_literal<literal_ab>;
+    using e9      = lexy::engine_literal<literal_e9>;
+    using a_bc    = lexy::engine_trie<trie_a_bc>;
+    using a_ab    = lexy::engine_trie<trie_a_ab>;
+    using a_abc   = lexy::engine_trie<trie_a_abc>;
+
+    SUBCASE("basic")
+    {
+        verify_dfa<char_ab>();
+        verify_dfa<char_ac>();
+        verify_dfa<ab>();
+        verify_dfa<e9>();
+        verify_dfa<a_bc>();
+        verify_dfa<a_abc>();
+    }
+    SUBCASE("while")
+    {
+        verify_dfa<lexy::engine_while<char_ab>>();
+        verify_dfa<lexy::engine_while<ab>>();
+        verify_dfa<lexy::engine_while<e9>>();
+        verify_dfa<lexy::engine_while<a_bc>>();
+
+        // The trie can match a prefix of another match, so the loop needs backtracking.
+        CHECK(!lexy::engine_is_regular<lexy::engine_while<a_ab>, encoding>);
+    }
+    SUBCASE("digits")
+    {
+        verify_dfa<lexy::engine_digits<char_ab>>();
+        verify_dfa<lexy::engine_minus<lexy::engine_digits<char_ac>, ab>>();
+    }
+    SUBCASE("minus")
+    {
+        verify_dfa<lexy::engine_minus<lexy::engine_while<char_ab>, ab>>();
+        verify_dfa<lexy::engine_minus<a_abc, ab, char_ac>>();
+        verify_dfa<lexy::engine_minus<lexy::engine_while<a_bc>, a_bc, lexy::engine_while<ab>>>();
+        verify_dfa<lexy::engine_while<lexy::engine_minus<char_ac, e9>>>();
+
+        using until = lexy::engine_until<ab>;
+        CHECK(!lexy::engine_is_regular<lexy::engine_minus<until, ab>, encoding>);
+    }
+
+    SUBCASE("_fused_engine")
+    {
+        using fused_while = lexy::_fused_engine<lexy::engine_while<char_ab>, encoding>;
+        CHECK(std::is_same_v<fused_while,
+                             lexy::engine_dfa<lexy::dfa<lexy::engine_while<char_ab>, encoding>>>);
+
+        // Single engines are already as fast as the DFA.
+        CHECK(std::is_same_v<lexy::_fused_engine<ab, encoding>, ab>);
+        // Non-regular engines aren't fused.
+        using while_a_ab = lexy::engine_while<a_ab>;
+        CHECK(std::is_same_v<lexy::_fused_engine<while_a_ab, encoding>, while_a_ab>);
+        // Neither are engines on encodings with bigger code units.
+        using while_ab = lexy::engine_while<char_ab>;
+        CHECK(std::is_same_v<lexy::_fused_engine<while_ab, lexy::utf16_encoding>, while_ab>);
+    }
+}
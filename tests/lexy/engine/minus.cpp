@@ -6,15 +6,25 @@
 
 #include "verify.hpp"
 #include <lexy/_detail/nttp_string.hpp>
+#include <lexy/engine/char_class.hpp>
+#include <lexy/engine/code_point.hpp>
 #include <lexy/engine/failure.hpp>
 #include <lexy/engine/literal.hpp>
+#include <lexy/engine/trie.hpp>
 #include <lexy/engine/until.hpp>
+#include <lexy/engine/while.hpp>
 
 namespace
 {
 constexpr auto condition_trie = lexy::linear_trie<LEXY_NTTP_STRING("!")>;
 constexpr auto trie_a         = lexy::linear_trie<LEXY_NTTP_STRING("a!")>;
 constexpr auto trie_bc        = lexy::linear_trie<LEXY_NTTP_STRING("bc!")>;
+
+constexpr auto trie_lt = lexy::linear_trie<LEXY_NTTP_STRING("<")>;
+constexpr auto trie_ab = lexy::linear_trie<LEXY_NTTP_STRING("ab")>;
+constexpr auto set_ac  = lexy::_make_strie<LEXY_NTTP_STRING("ac")>();
+constexpr auto trie_a_ab_abc
+    = lexy::trie<char, LEXY_NTTP_STRING("a"), LEXY_NTTP_STRING("ab"), LEXY_NTTP_STRING("abc")>;
 } // namespace
 
 TEST_CASE("engine_minus")
@@ -57,3 +67,69 @@ TEST_CASE("engine_minus")
     CHECK(bcd.count == 4);
 }
 
+TEST_CASE("engine_minus excepts")
+{
+    SUBCASE("code point minus literal")
+    {
+        using except_lt = lexy::engine_literal<trie_lt>;
+        using engine    = lexy::engine_minus<lexy::engine_cp_ascii, except_lt>;
+        CHECK(lexy::engine_match_length<except_lt> == 1);
+
+        auto empty = engine_matches<engine, lexy::ascii_encoding>("");
+        CHECK(!empty);
+        CHECK(empty.ec != engine::error_code::minus_failure);
+
+        auto a = engine_matches<engine, lexy::ascii_encoding>("a<");
+        CHECK(a);
+        CHECK(a.count == 1);
+
+        auto lt = engine_matches<engine, lexy::ascii_encoding>("<a");
+        CHECK(!lt);
+        CHECK(lt.count == 1);
+        CHECK(lt.ec == engine::error_code::minus_failure);
+    }
+    SUBCASE("each except matches from the beginning")
+    {
+        using matcher   = lexy::engine_trie<trie_a_ab_abc>;
+        using except_ab = lexy::engine_literal<trie_ab>;
+        using except_ac = lexy::engine_char_set<set_ac>;
+        using engine    = lexy::engine_minus<matcher, except_ab, except_ac>;
+
+        auto a = engine_matches<engine>("a");
+        CHECK(!a);
+        CHECK(a.ec == engine::error_code::minus_failure);
+        auto ab = engine_matches<engine>("ab");
+        CHECK(!ab);
+        CHECK(ab.ec == engine::error_code::minus_failure);
+
+        // `ab` matches a prefix and `ac` would match the rest, but neither matches all of it.
+        auto abc = engine_matches<engine>("abc");
+        CHECK(abc);
+        CHECK(abc.count == 3);
+    }
+}
+
+TEST_CASE("engine_minus multiple excepts")
+{
+    // An except that matches a prefix must not leave the next except in the middle of the input.
+    using matcher   = lexy::engine_trie<trie_a_ab_abc>;
+    using except_ab = lexy::engine_literal<trie_ab>;
+    using except_ac = lexy::engine_while<lexy::engine_char_set<set_ac>>;
+    using engine    = lexy::engine_minus<matcher, except_ab, except_ac>;
+
+    auto abc = engine_matches<engine>("abc");
+    CHECK(abc);
+    CHECK(abc.count == 3);
+
+    auto ab = engine_matches<engine>("ab");
+    CHECK(!ab);
+    CHECK(ab.ec == engine::error_code::minus_failure);
+    auto a = engine_matches<engine>("a");
+    CHECK(!a);
+    CHECK(a.ec == engine::error_code::minus_failure);
+
+    // The DFA runs all excepts from the beginning as well.
+    using dfa = lexy::engine_dfa<lexy::dfa<engine, lexy::default_encoding>>;
+    CHECK(engine_matches<dfa>("abc").count == 3);
+    CHECK(!engine_matches<dfa>("ab"));
+}
@@ -8,6 +8,8 @@
 #include <lexy/_detail/string_view.hpp>
 #include <lexy/callback.hpp>
 #include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/code_point.hpp>
+#include <lexy/dsl/newline.hpp>
 #include <lexy/input/string_input.hpp>
 
 namespace
@@ -168,3 +170,143 @@ TEST_CASE("make_error_location")
     }
 }
 
+namespace
+{
+// Wraps the engine of a token, so the location is always computed by matching the tokens.
+template <typename Token>
+struct opaque_token : lexy::dsl::token_base<opaque_token<Token>>
+{
+    struct token_engine : lexy::engine_matcher_base
+    {
+        using error_code = typename Token::token_engine::error_code;
+
+        template <typename Reader>
+        static constexpr error_code match(Reader& reader)
+        {
+            return Token::token_engine::match(reader);
+        }
+    };
+};
+
+template <typename Input, typename TokenCP>
+void verify_location_counting(const Input& input, TokenCP)
+{
+    using char_type = typename lexy::input_reader<Input>::char_type;
+    REQUIRE(lexy::_location_counting_for<Input, TokenCP, decltype(lexy::dsl::newline)>
+            != lexy::_location_counting::none);
+
+    for (auto pos = input.begin(); pos <= input.end(); ++pos)
+    {
+        INFO(pos - input.begin());
+        if (pos != input.begin() && pos[-1] == '\r' && pos[0] == '\n')
+            // The tokens can't find positions inside a newline.
+            continue;
+        if (pos != input.end() && (static_cast<unsigned char>(*pos) & 0xC0) == 0x80
+            && sizeof(char_type) == 1
+            && std::is_same_v<TokenCP, std::decay_t<decltype(lexy::dsl::code_point)>>)
+            // Or inside a code point.
+            continue;
+
+        auto expected = lexy::make_error_location(input, pos, opaque_token<TokenCP>{},
+                                                  opaque_token<lexyd::_nl>{});
+        auto actual   = lexy::make_error_location(input, pos, TokenCP{}, lexy::dsl::newline);
+        CHECK(actual.line == expected.line);
+        CHECK(actual.column == expected.column);
+        CHECK(actual.context.begin() == expected.context.begin());
+        CHECK(actual.context.end() == expected.context.end());
+    }
+}
+} // namespace
+
+TEST_CASE("make_error_location counting")
+{
+    SUBCASE("ASCII")
+    {
+        static constexpr char array[]
+            = "A line that is longer than the sixteen bytes of a block.\n"
+              "\xFF is not ASCII\r\n\r\r\n"
+              "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"
+              "The last line without newline, it also has \x80\x81 bytes that aren't ASCII.";
+        auto input = lexy::zstring_input(array);
+        verify_location_counting(input, lexy::dsl::ascii::character);
+    }
+    SUBCASE("UTF-8")
+    {
+        // U+00E4, U+00F6, U+00FC, U+20AC and U+1F600.
+        static constexpr char array[]
+            = "A line that is longer than the sixteen bytes of a block.\n"
+              "\xC3\xA4\xC3\xB6\xC3\xBC \xE2\x82\xAC \xF0\x9F\x98\x80 are code points\r\n\r\r\n"
+              "Ill-formed: \xFF \xC3" "a \xC0\x80 \x80 \xED\xA0\x80\n"
+              "Truncated: \xE2\x82 \xF0\x9F\x98, still code points\n"
+              "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"
+              "\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC"
+              "\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC\xC3\xA4\xC3\xB6\xC3\xBC";
+        auto input = lexy::zstring_input<lexy::utf8_encoding>(array);
+        verify_location_counting(input, lexy::dsl::code_point);
+        verify_location_counting(input, lexy::dsl::ascii::character);
+    }
+}
+
+TEST_CASE("line_index")
+{
+    constexpr auto character = lexy::dsl::ascii::character;
+
+    auto verify = [&](const auto& input, std::size_t line_count, auto newline) {
+        auto index = lexy::line_index(input, character, newline);
+        CHECK(index.line_count() == line_count);
+
+        for (auto pos = input.begin(); pos <= input.end(); ++pos)
+        {
+            INFO(pos - input.begin());
+            if (pos != input.begin() && pos[-1] == '\r' && pos[0] == '\n')
+                // make_error_location() can't find positions inside a newline.
+                continue;
+
+            auto expected = lexy::make_error_location(input, pos, character, newline);
+            auto actual   = index.location(pos);
+            CHECK(actual.line == expected.line);
+            CHECK(actual.column == expected.column);
+            CHECK(actual.context.begin() == expected.context.begin());
+            CHECK(actual.context.end() == expected.context.end());
+        }
+    };
+
+    SUBCASE("empty")
+    {
+        auto input = lexy::zstring_input("");
+        verify(input, 1, lexy::dsl::newline);
+    }
+    SUBCASE("basic")
+    {
+        auto input = lexy::zstring_input("Line 1\n"
+                                         "Line 2\n"
+                                         "Line 3\n");
+        verify(input, 4, lexy::dsl::newline);
+    }
+    SUBCASE("no trailing newline")
+    {
+        auto input = lexy::zstring_input("Line 1\n"
+                                         "Line 2\r\n"
+                                         "\n"
+                                         "Line 4");
+        verify(input, 4, lexy::dsl::newline);
+        // \r is a newline on its own for ASCII.
+        verify(input, 5, lexy::dsl::ascii::newline);
+    }
+    SUBCASE("weird characters")
+    {
+        // 0xFF isn't an ascii character and a single \r isn't a newline.
+        static constexpr char array[]
+            = {'a', 'b', 'c', char(0xFF), 'd', '\r', '\n', 'e', '\r', 'f', '\n', '\0'};
+        auto input = lexy::zstring_input(array);
+        verify(input, 3, lexy::dsl::newline);
+    }
+    SUBCASE("long lines")
+    {
+        auto input = lexy::zstring_input("This line is longer than the sixteen bytes we search.\n"
+                                         "And this one as well, just to be sure that it works.\n"
+                                         "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"
+                                         "Done.");
+        verify(input, 29, lexy::dsl::newline);
+    }
+}
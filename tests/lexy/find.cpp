@@ -0,0 +1,203 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/find.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/dsl/alternative.hpp>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/digit.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/minus.hpp>
+#include <lexy/dsl/token.hpp>
+#include <lexy/dsl/while.hpp>
+#include <lexy/input/buffer.hpp>
+#include <lexy/input/range_input.hpp>
+#include <lexy/input/string_input.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace
+{
+template <typename Token>
+constexpr const auto& first_code_units(Token)
+{
+    return lexy::engine_first_code_units<typename Token::token_engine, lexy::default_encoding>;
+}
+
+template <typename Input, typename Token>
+std::vector<std::string> matches(const Input& input, Token token)
+{
+    std::vector<std::string> result;
+    for (auto lexeme : lexy::find_all(input, token))
+        result.emplace_back(lexeme.begin(), lexeme.end());
+
+    std::vector<std::string> scanned;
+    auto                     count = lexy::scan(input, token, [&](auto lexeme) {
+        scanned.emplace_back(lexeme.begin(), lexeme.end());
+    });
+    CHECK(count == scanned.size());
+    CHECK(scanned == result);
+
+    return result;
+}
+
+using strings = std::vector<std::string>;
+} // namespace
+
+TEST_CASE("engine_first_code_units")
+{
+    SUBCASE("literal")
+    {
+        auto& set = first_code_units(LEXY_LIT("abc"));
+        CHECK(set.size() == 1);
+        CHECK(set.contains('a'));
+    }
+    SUBCASE("trie")
+    {
+        auto& set = first_code_units(LEXY_LIT("abc") / LEXY_LIT("ab") / LEXY_LIT("xyz"));
+        CHECK(set.size() == 2);
+        CHECK(set.contains('a'));
+        CHECK(set.contains('x'));
+    }
+    SUBCASE("char class")
+    {
+        auto& lower = first_code_units(lexy::dsl::ascii::lower);
+        CHECK(lower.size() == 26);
+        CHECK(lower.range_count() == 1);
+        CHECK(lower.range_min(0) == 'a');
+        CHECK(lower.range_max(0) == 'z');
+
+        auto& alpha = first_code_units(lexy::dsl::ascii::alpha);
+        CHECK(alpha.size() == 52);
+        CHECK(alpha.range_count() == 2);
+
+        auto& digit = first_code_units(lexy::dsl::digit<>);
+        CHECK(digit.size() == 10);
+    }
+    SUBCASE("composite")
+    {
+        auto& digits = first_code_units(lexy::dsl::digits<>);
+        CHECK(digits.size() == 10);
+
+        auto& minus = first_code_units(lexy::dsl::ascii::lower - LEXY_LIT("x"));
+        CHECK(minus.size() == 26);
+    }
+    SUBCASE("unknown")
+    {
+        auto  word = lexy::dsl::token(lexy::dsl::while_one(lexy::dsl::ascii::alpha));
+        auto& set  = first_code_units(word);
+        CHECK(set.size() == 0x100);
+    }
+}
+
+TEST_CASE("find_all")
+{
+    SUBCASE("literal")
+    {
+        auto input = lexy::zstring_input("abc ab abcabc xabcx");
+        CHECK(matches(input, LEXY_LIT("abc")) == strings{"abc", "abc", "abc", "abc"});
+        CHECK(matches(input, LEXY_LIT("xyz")).empty());
+        CHECK(matches(lexy::zstring_input(""), LEXY_LIT("abc")).empty());
+    }
+    SUBCASE("trie")
+    {
+        auto input = lexy::zstring_input("if iff else elif");
+        CHECK(matches(input, LEXY_LIT("if") / LEXY_LIT("else") / LEXY_LIT("elif"))
+              == strings{"if", "if", "else", "elif"});
+    }
+    SUBCASE("char class")
+    {
+        auto input = lexy::zstring_input("12 ab 3456 c7");
+        CHECK(matches(input, lexy::dsl::digits<>) == strings{"12", "3456", "7"});
+        CHECK(matches(input, lexy::dsl::ascii::alpha) == strings{"a", "b", "c"});
+        CHECK(matches(input, lexy::dsl::ascii::punct).empty());
+    }
+    SUBCASE("no prefilter")
+    {
+        auto input = lexy::zstring_input("12 ab 3456 c7");
+        auto word  = lexy::dsl::token(lexy::dsl::while_one(lexy::dsl::ascii::alpha));
+        CHECK(matches(input, word) == strings{"ab", "c"});
+    }
+    SUBCASE("empty matches are ignored")
+    {
+        auto input = lexy::zstring_input("ab 12");
+        CHECK(matches(input, lexy::dsl::token(lexy::dsl::while_(lexy::dsl::digit<>)))
+              == strings{"12"});
+        CHECK(matches(input, LEXY_LIT("")).empty());
+    }
+    SUBCASE("big input")
+    {
+        // Matches at every offset of a 16 byte block, as well as in the tail.
+        std::string str;
+        strings     expected;
+        for (auto i = 0; i != 100; ++i)
+        {
+            str.append(std::size_t(i % 37), 'x');
+            str += i % 2 == 0 ? "42" : "abc";
+            expected.push_back(i % 2 == 0 ? "42" : "abc");
+        }
+
+        auto token = LEXY_LIT("abc") / lexy::dsl::digits<>;
+        CHECK(matches(lexy::string_input(str.data(), str.size()), token) == expected);
+        CHECK(matches(lexy::buffer(str.data(), str.size()), token) == expected);
+        CHECK(matches(lexy::padded_buffer<>(str.data(), str.size()), token) == expected);
+        CHECK(matches(lexy::padded_buffer<lexy::ascii_encoding>(str.data(), str.size()), token)
+              == expected);
+
+        // The last block of the padded search extends past the end.
+        str.append(20, 'x');
+        CHECK(matches(lexy::padded_buffer<>(str.data(), str.size()), token) == expected);
+        str.resize(str.size() - 20);
+
+        auto two = strings();
+        for (auto& s : expected)
+            if (s == "42")
+                two.push_back(s);
+        CHECK(matches(lexy::string_input(str.data(), str.size()), lexy::dsl::digits<>) == two);
+
+        std::list<char> list(str.begin(), str.end());
+        CHECK(matches(lexy::range_input(list.begin(), list.end()), token) == expected);
+    }
+}
+
+TEST_CASE("counting")
+{
+    // Long enough that the SIMD accumulator needs to be flushed, with bytes of all kinds.
+    std::vector<unsigned char> data;
+    for (auto i = 0u; i != 10000; ++i)
+        data.push_back(static_cast<unsigned char>(i * 13 % 0x101));
+    for (auto i = 0u; i < 10000; i += 3)
+        data[i] = '\n';
+
+    for (auto offset : {0u, 1u, 15u, 17u})
+        for (auto size : {0u, 1u, 16u, 33u, 64u, 127u, 4079u, 4080u, 4081u, 8160u, 8161u, 9000u})
+        {
+            INFO(offset);
+            INFO(size);
+            auto begin = data.data() + offset;
+            auto end   = begin + size;
+
+            auto newlines = std::size_t(0), ascii = std::size_t(0), code_points = std::size_t(0);
+            auto last_nl  = end;
+            for (auto ptr = begin; ptr != end; ++ptr)
+            {
+                if (*ptr == '\n')
+                {
+                    ++newlines;
+                    last_nl = ptr;
+                }
+                if (*ptr <= 0x7F)
+                    ++ascii;
+                if ((*ptr & 0xC0) != 0x80)
+                    ++code_points;
+            }
+
+            CHECK(lexy::_detail::count_code_unit(begin, end, '\n') == newlines);
+            CHECK(lexy::_detail::find_last_code_unit(begin, end, '\n') == last_nl);
+            CHECK(lexy::_detail::count_ascii(begin, end) == ascii);
+            CHECK(lexy::_detail::count_utf8_code_points(begin, end) == code_points);
+        }
+}
@@ -5,6 +5,7 @@
 #include <lexy/input/base.hpp>
 
 #include <doctest/doctest.h>
+#include <lexy/input/argv_input.hpp>
 #include <lexy/input/string_input.hpp>
 
 TEST_CASE("partial_reader()")
@@ -24,5 +25,30 @@ TEST_CASE("partial_reader()")
     partial.bump();
     CHECK(partial.peek() == lexy::default_encoding::eof());
     CHECK(partial.eof());
+
+    partial = lexy::partial_reader(input.reader(), end);
+    CHECK(partial.end() == end);
+    CHECK(partial.remaining() == 2);
+    partial.advance(2);
+    CHECK(partial.remaining() == 0);
+    CHECK(partial.eof());
+}
+
+TEST_CASE("is_contiguous_reader")
+{
+    using string_reader = lexy::input_reader<lexy::string_input<>>;
+    CHECK(lexy::is_contiguous_reader<string_reader>);
+
+    auto input   = lexy::zstring_input("abc");
+    auto partial = lexy::partial_reader(input.reader(), input.end());
+    CHECK(lexy::is_contiguous_reader<decltype(partial)>);
+
+    using argv_reader = lexy::input_reader<lexy::argv_input<>>;
+    CHECK(!lexy::is_contiguous_reader<argv_reader>);
+    using partial_argv_reader = decltype(lexy::partial_reader(LEXY_DECLVAL(argv_reader), {}));
+    CHECK(!lexy::is_contiguous_reader<partial_argv_reader>);
+
+    using range_reader = lexy::_detail::range_reader<lexy::default_encoding, const char*, int>;
+    CHECK(!lexy::is_contiguous_reader<range_reader>);
 }
 
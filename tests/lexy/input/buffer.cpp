@@ -4,6 +4,7 @@
 
 #include <lexy/input/buffer.hpp>
 
+#include <cstdint>
 #include <doctest/doctest.h>
 
 #if defined(__has_include) && __has_include(<memory_resource>)
@@ -209,7 +210,10 @@ TEST_CASE("buffer")
         const lexy::buffer buffer(str, 3);
 
         auto reader = buffer.reader();
+        CHECK(lexy::is_contiguous_reader<decltype(reader)>);
         CHECK(reader.cur() == buffer.data());
+        CHECK(reader.end() == buffer.data() + 3);
+        CHECK(reader.remaining() == 3);
         CHECK(reader.peek() == 'a');
         CHECK(!reader.eof());
 
@@ -227,13 +231,22 @@ TEST_CASE("buffer")
         CHECK(reader.cur() == buffer.data() + 3);
         CHECK(reader.peek() == lexy::default_encoding::eof());
         CHECK(reader.eof());
+        CHECK(reader.remaining() == 0);
+
+        reader = buffer.reader();
+        reader.advance(2);
+        CHECK(reader.cur() == buffer.data() + 2);
+        CHECK(reader.peek() == 'c');
     }
     SUBCASE("reader, sentinel")
     {
         const lexy::buffer<lexy::ascii_encoding> buffer(str, 3);
 
         auto reader = buffer.reader();
+        CHECK(lexy::is_contiguous_reader<decltype(reader)>);
         CHECK(reader.cur() == buffer.data());
+        CHECK(reader.end() == buffer.data() + 3);
+        CHECK(reader.remaining() == 3);
         CHECK(reader.peek() == 'a');
         CHECK(!reader.eof());
 
@@ -251,6 +264,159 @@ TEST_CASE("buffer")
         CHECK(reader.cur() == buffer.data() + 3);
         CHECK(reader.peek() == lexy::default_encoding::eof());
         CHECK(reader.eof());
+        CHECK(reader.remaining() == 0);
+
+        reader = buffer.reader();
+        reader.advance(2);
+        CHECK(reader.cur() == buffer.data() + 2);
+        CHECK(reader.peek() == 'c');
+    }
+}
+
+TEST_CASE("buffer::adopt")
+{
+    // Releases the memory the test owns.
+    struct pool_resource
+    {
+        int         deallocations = 0;
+        std::size_t bytes         = 0;
+
+        void* allocate(std::size_t, std::size_t)
+        {
+            FAIL("unexpected allocation");
+            return nullptr;
+        }
+        void deallocate(void*, std::size_t size, std::size_t)
+        {
+            ++deallocations;
+            bytes = size;
+        }
+
+        bool operator==(const pool_resource& other) const
+        {
+            return this == &other;
+        }
+    };
+
+    SUBCASE("sentinel")
+    {
+        using buffer_type = lexy::buffer<lexy::ascii_encoding, pool_resource>;
+        CHECK(buffer_type::adopt_capacity(3) == 4);
+
+        char          memory[] = {'a', 'b', 'c', 'x', 'x'};
+        pool_resource resource;
+        {
+            auto buffer = buffer_type::adopt(memory, 3, &resource);
+            CHECK(buffer.data() == memory);
+            CHECK(buffer.size() == 3);
+            CHECK(memory[3] == lexy::ascii_encoding::eof());
+            CHECK(memory[4] == 'x');
+
+            auto reader = buffer.reader();
+            CHECK(reader.peek() == 'a');
+            reader.advance(3);
+            CHECK(reader.eof());
+
+            auto moved = LEXY_MOV(buffer);
+            CHECK(moved.data() == memory);
+            CHECK(resource.deallocations == 0);
+        }
+        CHECK(resource.deallocations == 1);
+        CHECK(resource.bytes == 4);
+    }
+    SUBCASE("no sentinel")
+    {
+        using buffer_type = lexy::buffer<lexy::default_encoding, pool_resource>;
+        CHECK(buffer_type::adopt_capacity(3) == 3);
+
+        char          memory[] = {'a', 'b', 'c'};
+        pool_resource resource;
+        {
+            auto buffer = buffer_type::adopt(memory, 3, &resource);
+            CHECK(buffer.data() == memory);
+            CHECK(buffer.end() == memory + 3);
+        }
+        CHECK(resource.deallocations == 1);
+        CHECK(resource.bytes == 3);
+    }
+    SUBCASE("padded")
+    {
+        using buffer_type = lexy::buffer<lexy::ascii_encoding, pool_resource,
+                                         lexy::padded_buffer_policy<16>>;
+        CHECK(buffer_type::adopt_capacity(3) == 19);
+
+        alignas(64) char memory[19] = {'a', 'b', 'c'};
+        pool_resource    resource;
+        {
+            auto buffer = buffer_type::adopt(memory, 3, &resource);
+            for (auto i = 3; i != 19; ++i)
+                CHECK(memory[i] == lexy::ascii_encoding::eof());
+        }
+        CHECK(resource.bytes == 19);
+    }
+}
+
+TEST_CASE("padded_buffer")
+{
+    static const char str[] = {'a', 'b', 'c'};
+
+    SUBCASE("no sentinel")
+    {
+        const lexy::padded_buffer<lexy::default_encoding, 32> buffer(str, 3);
+        CHECK(reinterpret_cast<std::uintptr_t>(buffer.data()) % 64 == 0);
+        CHECK(buffer.size() == 3);
+        for (auto i = 0; i != 32; ++i)
+            CHECK(buffer.end()[i] == '\0');
+
+        auto reader = buffer.reader();
+        CHECK(lexy::reader_padding<decltype(reader)> == 32);
+        CHECK(reader.end() == buffer.end());
+        CHECK(reader.peek() == 'a');
+
+        reader.advance(3);
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.eof());
+    }
+    SUBCASE("sentinel")
+    {
+        const lexy::padded_buffer<lexy::ascii_encoding> buffer(str, 3);
+        CHECK(reinterpret_cast<std::uintptr_t>(buffer.data()) % 64 == 0);
+        for (auto i = 0; i != 64; ++i)
+            CHECK(buffer.end()[i] == lexy::ascii_encoding::eof());
+
+        auto reader = buffer.reader();
+        CHECK(lexy::reader_padding<decltype(reader)> == 64);
+        reader.advance(3);
+        CHECK(reader.eof());
+    }
+    SUBCASE("bigger code units")
+    {
+        const char16_t                                      data[] = {u'a', u'b'};
+        const lexy::padded_buffer<lexy::utf16_encoding, 15> buffer(data, 2);
+        CHECK(reinterpret_cast<std::uintptr_t>(buffer.data()) % 64 == 0);
+        for (auto i = 0; i != 8; ++i)
+            CHECK(buffer.end()[i] == 0);
+
+        // The padding is rounded up to entire code units.
+        CHECK(lexy::reader_padding<decltype(buffer.reader())> == 16);
+    }
+    SUBCASE("default policy")
+    {
+        using sentinel_reader = decltype(lexy::buffer<lexy::ascii_encoding>().reader());
+        CHECK(lexy::reader_padding<sentinel_reader> == 1);
+        using range_reader = decltype(lexy::buffer<lexy::default_encoding>().reader());
+        CHECK(lexy::reader_padding<range_reader> == 0);
+    }
+    SUBCASE("make_buffer")
+    {
+        const unsigned char data[] = {0xFE, 0xFF, 0x00, 0x61, 0x00, 0x62};
+        auto buffer = lexy::make_buffer<lexy::utf16_encoding, lexy::encoding_endianness::bom,
+                                        lexy::padded_buffer_policy<>>(data, sizeof(data));
+        CHECK(reinterpret_cast<std::uintptr_t>(buffer.data()) % 64 == 0);
+        CHECK(buffer.size() == 2);
+        CHECK(buffer.data()[0] == u'a');
+        CHECK(buffer.data()[1] == u'b');
+        CHECK(lexy::reader_padding<decltype(buffer.reader())> == 64);
     }
 }
 
@@ -427,5 +593,28 @@ TEST_CASE("make_buffer")
         CHECK(big_bom.size() == 1);
         CHECK(big_bom.data()[0] == 0x00112233);
     }
+    SUBCASE("long input")
+    {
+        // Long enough for the vectorized conversion and a remainder.
+        unsigned char long_str[2 + 4 * 37];
+        long_str[0] = 0xFE;
+        long_str[1] = 0xFF;
+        for (auto i = 2u; i != sizeof(long_str); ++i)
+            long_str[i] = static_cast<unsigned char>(i);
+
+        auto utf16 = lexy::make_buffer<lexy::utf16_encoding,
+                                       lexy::encoding_endianness::bom>(long_str, sizeof(long_str));
+        REQUIRE(utf16.size() == 2 * 37);
+        for (auto i = 0u; i != utf16.size(); ++i)
+            CHECK(utf16.data()[i] == ((2 * i + 2) << 8 | (2 * i + 3)));
+
+        auto utf32 = lexy::make_buffer<lexy::utf32_encoding,
+                                       lexy::encoding_endianness::little>(long_str + 2,
+                                                                          sizeof(long_str) - 2);
+        REQUIRE(utf32.size() == 37);
+        for (auto i = 0u; i != utf32.size(); ++i)
+            CHECK(utf32.data()[i]
+                  == ((4 * i + 5) << 24 | (4 * i + 4) << 16 | (4 * i + 3) << 8 | (4 * i + 2)));
+    }
 }
 
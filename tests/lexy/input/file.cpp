@@ -4,8 +4,11 @@
 
 #include <lexy/input/file.hpp>
 
+#include <cstdint>
 #include <cstdio>
 #include <doctest/doctest.h>
+#include <lexy/memory_resource.hpp>
+#include <string>
 
 #if defined(__has_include) && __has_include(<memory_resource>)
 #    include <memory_resource>
@@ -148,6 +151,103 @@ TEST_CASE("read_file")
         CHECK(reader.peek() == lexy::utf16_encoding::eof());
         CHECK(reader.eof());
     }
+    SUBCASE("custom encoding without BOM")
+    {
+        const unsigned char data[] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x00};
+        write_test_data(reinterpret_cast<const char*>(data));
+
+        auto big = lexy::read_file<lexy::utf16_encoding>(test_file_name);
+        REQUIRE(big);
+        REQUIRE(big.value().size() == 3);
+        CHECK(big.value().data()[0] == 0x1122);
+        CHECK(big.value().data()[1] == 0x3344);
+        // The incomplete code unit at the end is padded with zeroes.
+        CHECK(big.value().data()[2] == 0x5500);
+
+        auto little
+            = lexy::read_file<lexy::utf32_encoding, lexy::encoding_endianness::little>(
+                test_file_name);
+        REQUIRE(little);
+        REQUIRE(little.value().size() == 2);
+        CHECK(little.value().data()[0] == 0x44332211);
+        CHECK(little.value().data()[1] == 0x00000055);
+    }
+
+    SUBCASE("UTF-8 with BOM")
+    {
+        write_test_data("\xEF\xBB\xBF" "abc");
+
+        auto buffer = lexy::read_file<lexy::utf8_encoding>(test_file_name);
+        REQUIRE(buffer);
+        CHECK(buffer.value().size() == 3);
+
+        auto reader = buffer.value().reader();
+        CHECK(reader.peek() == 'a');
+        reader.advance(3);
+        CHECK(reader.eof());
+
+        auto with_bom = lexy::read_file<lexy::utf8_encoding, lexy::encoding_endianness::big>(
+            test_file_name);
+        REQUIRE(with_bom);
+        CHECK(with_bom.value().size() == 6);
+    }
+    SUBCASE("pool")
+    {
+        write_test_data("abc");
+
+        lexy::buffer_pool pool;
+        const char*       data;
+        {
+            auto buffer = lexy::read_file(test_file_name, &pool);
+            REQUIRE(buffer);
+            CHECK(buffer.value().size() == 3);
+            CHECK(buffer.value().data()[0] == 'a');
+            data = buffer.value().data();
+        }
+        CHECK(pool.cached_bytes() == lexy::buffer_pool::min_size);
+
+        // The next file reuses the memory of the previous one.
+        auto buffer = lexy::read_file(test_file_name, &pool);
+        REQUIRE(buffer);
+        CHECK(buffer.value().data() == data);
+        CHECK(pool.cached_bytes() == 0);
+    }
+    SUBCASE("padded buffer")
+    {
+        write_test_data("abc");
+
+        auto buffer = lexy::read_file<lexy::utf8_encoding>(test_file_name,
+                                                           lexy::padded_buffer_policy<32>{});
+        REQUIRE(buffer);
+        CHECK(reinterpret_cast<std::uintptr_t>(buffer.value().data()) % 64 == 0);
+        CHECK(buffer.value().size() == 3);
+
+        auto reader = buffer.value().reader();
+        CHECK(lexy::reader_padding<decltype(reader)> == 32);
+        CHECK(reader.peek() == 'a');
+        reader.advance(3);
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+        CHECK(reader.eof());
+    }
+#if defined(__linux__)
+    SUBCASE("file shorter than its size")
+    {
+        // Files in /sys report a size of 4096 bytes, but are usually a lot shorter.
+        constexpr auto path = "/sys/devices/system/cpu/online";
+
+        if (auto file = std::fopen(path, "rb"))
+        {
+            std::string expected;
+            for (auto c = std::fgetc(file); c != EOF; c = std::fgetc(file))
+                expected.push_back(char(c));
+            std::fclose(file);
+
+            auto buffer = lexy::read_file(path);
+            REQUIRE(buffer);
+            CHECK(std::string(buffer.value().data(), buffer.value().size()) == expected);
+        }
+    }
+#endif
 
     std::remove(test_file_name);
 }
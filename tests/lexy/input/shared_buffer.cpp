@@ -0,0 +1,115 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/input/shared_buffer.hpp>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+// Counts the allocations that haven't been freed yet.
+struct counting_resource
+{
+    int allocations = 0;
+
+    void* allocate(std::size_t bytes, std::size_t alignment)
+    {
+        ++allocations;
+        return lexy::_detail::default_memory_resource{}.allocate(bytes, alignment);
+    }
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+    {
+        --allocations;
+        lexy::_detail::default_memory_resource{}.deallocate(ptr, bytes, alignment);
+    }
+
+    bool operator==(const counting_resource& other) const
+    {
+        return this == &other;
+    }
+};
+} // namespace
+
+TEST_CASE("shared_buffer")
+{
+    static const char str[] = {'a', 'b', 'c'};
+
+    SUBCASE("empty")
+    {
+        lexy::shared_buffer<> buffer;
+        CHECK(buffer.use_count() == 0);
+        CHECK(buffer.empty());
+        CHECK(buffer.data() == nullptr);
+        CHECK(buffer.size() == 0);
+
+        auto copy = buffer;
+        CHECK(copy.use_count() == 0);
+    }
+    SUBCASE("ownership")
+    {
+        counting_resource resource;
+        {
+            auto buffer = lexy::shared_buffer(lexy::buffer(str, 3, &resource));
+            CHECK(buffer.use_count() == 1);
+            CHECK(buffer.size() == 3);
+            CHECK(resource.allocations == 2);
+
+            auto copy = buffer;
+            CHECK(buffer.use_count() == 2);
+            CHECK(copy.data() == buffer.data());
+            CHECK(resource.allocations == 2);
+
+            auto moved = LEXY_MOV(copy);
+            CHECK(buffer.use_count() == 2);
+            CHECK(copy.use_count() == 0);
+
+            moved = lexy::shared_buffer<lexy::default_encoding, counting_resource>();
+            CHECK(buffer.use_count() == 1);
+
+            copy = buffer;
+            CHECK(buffer.use_count() == 2);
+        }
+        CHECK(resource.allocations == 0);
+    }
+    SUBCASE("reader")
+    {
+        auto buffer = lexy::shared_buffer(lexy::buffer<lexy::ascii_encoding>(str, 3));
+        CHECK(buffer.begin() != str);
+        CHECK(buffer.end() == buffer.begin() + 3);
+
+        auto reader = buffer.reader();
+        CHECK(reader.cur() == buffer.data());
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        reader.bump();
+        reader.bump();
+        CHECK(reader.eof());
+    }
+}
+
+TEST_CASE("shared_lexeme")
+{
+    static const char str[] = {'a', 'b', 'c'};
+
+    lexy::shared_lexeme<> lexeme;
+    {
+        auto buffer = lexy::shared_buffer(lexy::buffer(str, 3));
+
+        auto reader = buffer.reader();
+        reader.bump();
+        lexeme = lexy::shared_lexeme(buffer, lexy::lexeme(reader, buffer.begin()));
+        CHECK(buffer.use_count() == 2);
+    }
+
+    CHECK(lexeme.buffer().use_count() == 1);
+    CHECK(!lexeme.empty());
+    CHECK(lexeme.begin() == lexeme.buffer().begin());
+    CHECK(lexeme.size() == 1);
+    CHECK(lexeme[0] == 'a');
+
+    auto unowned = lexy::shared_lexeme<>(lexeme.lexeme());
+    CHECK(unowned.buffer().use_count() == 0);
+    CHECK(unowned.data() == lexeme.data());
+}
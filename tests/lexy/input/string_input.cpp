@@ -96,3 +96,56 @@ TEST_CASE("string_input")
     }
 }
 
+
+TEST_CASE("cstring_input")
+{
+    static const char str[] = {'a', 'b', 'c', '\0', 'd'};
+
+    SUBCASE("basic")
+    {
+        lexy::cstring_input<> input;
+        CHECK(input.reader().peek() == lexy::default_encoding::eof());
+        CHECK(input.reader().eof());
+
+        input = lexy::cstring_input(str);
+        CHECK(input.begin() == str);
+
+        auto reader = input.reader();
+        CHECK(reader.cur() == str);
+        CHECK(reader.peek() == 'a');
+        CHECK(!reader.eof());
+
+        reader.bump();
+        CHECK(reader.cur() == str + 1);
+        CHECK(reader.peek() == 'b');
+        CHECK(!reader.eof());
+
+        reader.bump();
+        CHECK(reader.cur() == str + 2);
+        CHECK(reader.peek() == 'c');
+        CHECK(!reader.eof());
+
+        reader.bump();
+        CHECK(reader.cur() == str + 3);
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(reader.eof());
+    }
+    SUBCASE("sentinel encoding")
+    {
+        auto input  = lexy::cstring_input<lexy::ascii_encoding>(str);
+        auto reader = input.reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        reader.bump();
+        reader.bump();
+        CHECK(reader.peek() == lexy::ascii_encoding::eof());
+        CHECK(reader.eof());
+    }
+    SUBCASE("converting ctor")
+    {
+        auto input = lexy::cstring_input<lexy::raw_encoding>(str);
+        CHECK(input.begin() == reinterpret_cast<const unsigned char*>(str));
+        CHECK(input.reader().peek() == 'a');
+    }
+}
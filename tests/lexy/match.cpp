@@ -45,3 +45,39 @@ TEST_CASE("match")
     }
 }
 
+TEST_CASE("match_prefix")
+{
+    SUBCASE("input")
+    {
+        auto input  = lexy::zstring_input("abcabc123");
+        auto result = lexy::match_prefix<production>(input);
+        REQUIRE(result);
+        CHECK(result.value() == input.begin() + 6);
+
+        auto no_match = lexy::match_prefix<production>(lexy::zstring_input("def"));
+        CHECK(!no_match);
+    }
+    SUBCASE("reader")
+    {
+        auto input  = lexy::zstring_input("abc123abcabc");
+        auto reader = input.reader();
+
+        auto first = lexy::match_prefix<production>(reader);
+        REQUIRE(first);
+        CHECK(first.value() == input.begin() + 3);
+        CHECK(reader.cur() == input.begin() + 3);
+
+        auto second = lexy::match_prefix<production>(reader);
+        CHECK(!second);
+        CHECK(reader.cur() == input.begin() + 3);
+
+        // Skip the digits and continue scanning.
+        for (auto i = 0; i != 3; ++i)
+            reader.bump();
+
+        auto third = lexy::match_prefix<production>(reader);
+        REQUIRE(third);
+        CHECK(third.value() == input.begin() + 12);
+        CHECK(reader.eof());
+    }
+}
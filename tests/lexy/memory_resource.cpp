@@ -0,0 +1,113 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/memory_resource.hpp>
+
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <lexy/input/buffer.hpp>
+#include <string>
+
+TEST_CASE("buffer_pool")
+{
+    lexy::buffer_pool pool(4096);
+    CHECK(pool.cached_bytes() == 0);
+
+    SUBCASE("size classes")
+    {
+        auto small = pool.allocate(1, 1);
+        CHECK(reinterpret_cast<std::uintptr_t>(small) % 64 == 0);
+        pool.deallocate(small, 1, 1);
+        CHECK(pool.cached_bytes() == 256);
+
+        // Same size class.
+        auto other = pool.allocate(200, 8);
+        CHECK(other == small);
+        CHECK(pool.cached_bytes() == 0);
+
+        // Bigger size class.
+        auto big = pool.allocate(257, 1);
+        CHECK(big != small);
+        pool.deallocate(big, 257, 1);
+        CHECK(pool.cached_bytes() == 512);
+
+        pool.deallocate(other, 200, 8);
+        CHECK(pool.cached_bytes() == 768);
+
+        pool.release();
+        CHECK(pool.cached_bytes() == 0);
+    }
+    SUBCASE("cache limit")
+    {
+        auto a = pool.allocate(4096, 1);
+        auto b = pool.allocate(4096, 1);
+        pool.deallocate(a, 4096, 1);
+        CHECK(pool.cached_bytes() == 4096);
+        pool.deallocate(b, 4096, 1);
+        CHECK(pool.cached_bytes() == 4096);
+    }
+    SUBCASE("not pooled")
+    {
+        auto huge = pool.allocate(lexy::buffer_pool::max_size + 1, 1);
+        pool.deallocate(huge, lexy::buffer_pool::max_size + 1, 1);
+        CHECK(pool.cached_bytes() == 0);
+
+        auto aligned = pool.allocate(16, 128);
+        CHECK(reinterpret_cast<std::uintptr_t>(aligned) % 128 == 0);
+        pool.deallocate(aligned, 16, 128);
+        CHECK(pool.cached_bytes() == 0);
+    }
+    SUBCASE("buffer")
+    {
+        static const char str[] = {'a', 'b', 'c'};
+
+        const char* data;
+        {
+            lexy::buffer<lexy::ascii_encoding, lexy::buffer_pool> buffer(str, 3, &pool);
+            data = buffer.data();
+        }
+        CHECK(pool.cached_bytes() == 256);
+
+        lexy::padded_buffer<lexy::ascii_encoding, 64, lexy::buffer_pool> buffer(str, 3, &pool);
+        CHECK(buffer.data() == data);
+    }
+}
+
+TEST_CASE("huge_page_resource")
+{
+    lexy::huge_page_resource resource(64 * 1024);
+    CHECK(resource.threshold() == 64 * 1024);
+    CHECK(resource == lexy::huge_page_resource(64 * 1024));
+    CHECK(resource != lexy::huge_page_resource());
+
+    SUBCASE("small")
+    {
+        auto memory = static_cast<char*>(resource.allocate(100, 1));
+        memory[0]   = 'a';
+        memory[99]  = 'b';
+        resource.deallocate(memory, 100, 1);
+    }
+    SUBCASE("big")
+    {
+        auto size   = std::size_t(3) * 1024 * 1024 + 1;
+        auto memory = static_cast<char*>(resource.allocate(size, 64));
+#if defined(__linux__)
+        CHECK(reinterpret_cast<std::uintptr_t>(memory) % 4096 == 0);
+#endif
+        for (auto i = std::size_t(0); i < size; i += 4096)
+            memory[i] = 'a';
+        memory[size - 1] = 'b';
+        resource.deallocate(memory, size, 64);
+    }
+    SUBCASE("buffer")
+    {
+        std::string str(128 * 1024, 'a');
+
+        lexy::padded_buffer<lexy::ascii_encoding, 64, lexy::huge_page_resource> buffer(str,
+                                                                                       &resource);
+        CHECK(buffer.size() == str.size());
+        CHECK(buffer.data()[0] == 'a');
+        CHECK(buffer.end()[0] == lexy::ascii_encoding::eof());
+    }
+}
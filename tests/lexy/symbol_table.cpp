@@ -0,0 +1,119 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/symbol_table.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/input/string_input.hpp>
+#include <string>
+#include <vector>
+
+TEST_CASE("symbol_table")
+{
+    SUBCASE("empty")
+    {
+        lexy::symbol_table<> table;
+        CHECK(table.empty());
+        CHECK(table.size() == 0);
+        CHECK(table.lookup("") == table.npos);
+        CHECK(table.lookup("abc") == table.npos);
+
+        auto input  = lexy::zstring_input("abc");
+        auto reader = input.reader();
+        CHECK(table.match(reader) == table.npos);
+        CHECK(reader.cur() == input.begin());
+    }
+    SUBCASE("lookup")
+    {
+        lexy::symbol_table<> table{"a", "abc", "abd", "b", "abc", ""};
+        CHECK(!table.empty());
+        CHECK(table.size() == 5);
+
+        CHECK(table.lookup("a") == 0);
+        CHECK(table.lookup("abc") == 1);
+        CHECK(table.lookup("abd") == 2);
+        CHECK(table.lookup("b") == 3);
+        CHECK(table.lookup("") == 5);
+
+        CHECK(table.lookup("ab") == table.npos);
+        CHECK(table.lookup("abcd") == table.npos);
+        CHECK(table.lookup("c") == table.npos);
+        CHECK(table.lookup(lexy::_detail::string_view("a\0", 2)) == table.npos);
+    }
+    SUBCASE("match")
+    {
+        lexy::symbol_table<> table{"a", "abc", "abd", "b"};
+
+        auto match = [&](const char* str, std::size_t expected_length) {
+            auto input  = lexy::zstring_input(str);
+            auto reader = input.reader();
+            auto id     = table.match(reader);
+            CHECK(reader.cur() - input.begin() == (id == table.npos ? 0 : expected_length));
+            return id;
+        };
+
+        CHECK(match("", 0) == table.npos);
+        CHECK(match("a", 1) == 0);
+        CHECK(match("ab", 1) == 0);
+        CHECK(match("abc", 3) == 1);
+        CHECK(match("abcd", 3) == 1);
+        CHECK(match("abd", 3) == 2);
+        CHECK(match("b", 1) == 3);
+        CHECK(match("bc", 1) == 3);
+        CHECK(match("c", 0) == table.npos);
+    }
+    SUBCASE("match with empty string")
+    {
+        lexy::symbol_table<> table{"a", "ab", ""};
+
+        auto match = [&](const char* str, std::size_t expected_length) {
+            auto input  = lexy::zstring_input(str);
+            auto reader = input.reader();
+            auto id     = table.match(reader);
+            CHECK(reader.cur() - input.begin() == expected_length);
+            return id;
+        };
+
+        CHECK(match("", 0) == 2);
+        CHECK(match("a", 1) == 0);
+        CHECK(match("ab", 2) == 1);
+        CHECK(match("b", 0) == 2);
+        CHECK(match("ac", 1) == 0);
+    }
+    SUBCASE("range")
+    {
+        std::vector<std::string> strings;
+        for (auto i = 0; i != 2000; ++i)
+            strings.push_back("sym" + std::to_string(i * 7919 % 2000));
+
+        lexy::symbol_table<> table(strings);
+        REQUIRE(table.size() == strings.size());
+        for (auto i = 0u; i != strings.size(); ++i)
+            CHECK(table.lookup(strings[i].data(), strings[i].data() + strings[i].size()) == i);
+        CHECK(table.lookup("sym") == table.npos);
+        CHECK(table.lookup("sym2000") == table.npos);
+
+        auto copy = table;
+        CHECK(copy.size() == table.size());
+        CHECK(copy.lookup("sym42") == table.lookup("sym42"));
+
+        auto moved = LEXY_MOV(copy);
+        CHECK(moved.lookup("sym42") == table.lookup("sym42"));
+    }
+    SUBCASE("UTF-16")
+    {
+        lexy::symbol_table<lexy::utf16_encoding> table{u"ä", u"Ǥ", u"a"};
+        CHECK(table.size() == 3);
+        CHECK(table.lookup(u"ä") == 0);
+        CHECK(table.lookup(u"Ǥ") == 1);
+        CHECK(table.lookup(u"a") == 2);
+        CHECK(table.lookup(u"ǥ") == table.npos);
+        CHECK(table.lookup(u"aä") == table.npos);
+
+        auto input  = lexy::zstring_input<lexy::utf16_encoding>(u"Ǥa");
+        auto reader = input.reader();
+        CHECK(table.match(reader) == 1);
+        CHECK(reader.cur() == input.begin() + 1);
+    }
+}
@@ -0,0 +1,134 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/tokenize.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/token.hpp>
+#include <lexy/dsl/while.hpp>
+#include <lexy/input/string_input.hpp>
+#include <string>
+
+namespace
+{
+struct token
+{
+    std::uint16_t kind;
+    std::uint32_t offset, length;
+};
+
+template <typename MemoryResource>
+void check_stream(const lexy::token_stream<MemoryResource>& stream,
+                  std::initializer_list<token>              expected)
+{
+    REQUIRE(stream.size() == expected.size());
+
+    auto idx = std::size_t(0);
+    for (auto& tok : expected)
+    {
+        CHECK(stream.kind(idx) == tok.kind);
+        CHECK(stream.offset(idx) == tok.offset);
+        CHECK(stream.length(idx) == tok.length);
+
+        CHECK(stream.kinds()[idx] == tok.kind);
+        CHECK(stream.offsets()[idx] == tok.offset);
+        CHECK(stream.lengths()[idx] == tok.length);
+        ++idx;
+    }
+}
+
+constexpr auto id    = lexy::dsl::token(lexy::dsl::while_one(lexy::dsl::ascii::alpha));
+constexpr auto ws    = lexy::dsl::token(lexy::dsl::while_one(lexy::dsl::ascii::space));
+constexpr auto kw_if = LEXY_LIT("if");
+constexpr auto eq    = LEXY_LIT("=");
+constexpr auto eq_eq = LEXY_LIT("==");
+} // namespace
+
+TEST_CASE("tokenize")
+{
+    constexpr auto error = lexy::token_stream<>::error_kind;
+
+    SUBCASE("empty")
+    {
+        auto stream = lexy::tokenize(lexy::zstring_input(""), id, ws);
+        CHECK(stream.empty());
+
+        auto copy = stream;
+        CHECK(copy.empty());
+    }
+    SUBCASE("basic")
+    {
+        auto stream = lexy::tokenize(lexy::zstring_input("abc  de f"), id, ws);
+        check_stream(stream, {{0, 0, 3}, {1, 3, 2}, {0, 5, 2}, {1, 7, 1}, {0, 8, 1}});
+    }
+    SUBCASE("longest match")
+    {
+        auto stream = lexy::tokenize(lexy::zstring_input("a = b == c"), id, ws, eq, eq_eq);
+        check_stream(stream, {{0, 0, 1},
+                              {1, 1, 1},
+                              {2, 2, 1},
+                              {1, 3, 1},
+                              {0, 4, 1},
+                              {1, 5, 1},
+                              {3, 6, 2},
+                              {1, 8, 1},
+                              {0, 9, 1}});
+    }
+    SUBCASE("first token wins ties")
+    {
+        auto keyword = lexy::tokenize(lexy::zstring_input("if iff"), kw_if, id, ws);
+        check_stream(keyword, {{0, 0, 2}, {2, 2, 1}, {1, 3, 3}});
+
+        auto identifier = lexy::tokenize(lexy::zstring_input("if iff"), id, kw_if, ws);
+        check_stream(identifier, {{0, 0, 2}, {2, 2, 1}, {0, 3, 3}});
+    }
+    SUBCASE("errors")
+    {
+        auto stream = lexy::tokenize(lexy::zstring_input("12ab3!c"), id);
+        check_stream(stream, {{error, 0, 2}, {0, 2, 2}, {error, 4, 2}, {0, 6, 1}});
+    }
+    SUBCASE("tokenize_into")
+    {
+        lexy::token_stream<> stream;
+        CHECK(lexy::tokenize_into(stream, lexy::zstring_input("ab"), id, ws));
+        CHECK(lexy::tokenize_into(stream, lexy::zstring_input(" "), id, ws));
+        check_stream(stream, {{0, 0, 2}, {1, 0, 1}});
+
+        stream.truncate(1);
+        check_stream(stream, {{0, 0, 2}});
+
+        stream.clear();
+        CHECK(stream.empty());
+    }
+    SUBCASE("many tokens")
+    {
+        std::string str;
+        for (auto i = 0; i != 1000; ++i)
+            str += "ab ";
+
+        auto stream = lexy::tokenize(lexy::string_input(str.data(), str.size()), id, ws);
+        REQUIRE(stream.size() == 2000);
+        for (auto i = std::uint32_t(0); i != 1000; ++i)
+        {
+            CHECK(stream.kind(2 * i) == 0);
+            CHECK(stream.offset(2 * i) == 3 * i);
+            CHECK(stream.kind(2 * i + 1) == 1);
+            CHECK(stream.offset(2 * i + 1) == 3 * i + 2);
+        }
+
+        auto copy = stream;
+        CHECK(copy.size() == 2000);
+        CHECK(copy.offset(1999) == 2999);
+
+        auto moved = LEXY_MOV(copy);
+        CHECK(moved.size() == 2000);
+        CHECK(copy.empty());
+
+        copy = moved;
+        CHECK(copy.size() == 2000);
+        CHECK(copy.length(1999) == 1);
+    }
+}
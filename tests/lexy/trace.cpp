@@ -0,0 +1,140 @@
+// Copyright (C) 2020-2021 Jonathan Müller <jonathanmueller.dev@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level directory of this distribution.
+
+#include <lexy/trace.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/dsl/list.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/production.hpp>
+#include <lexy/dsl/sequence.hpp>
+#include <lexy/input/string_input.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct item
+{
+    static constexpr auto name()
+    {
+        return "item";
+    }
+
+    static constexpr auto rule  = LEXY_LIT("ab");
+    static constexpr auto value = lexy::callback<int>([] { return 1; });
+};
+
+struct items
+{
+    static constexpr auto name()
+    {
+        return "items";
+    }
+
+    static constexpr auto rule  = lexy::dsl::list(lexy::dsl::p<item>) + LEXY_LIT(";");
+    static constexpr auto value = lexy::as_list<std::vector<int>> >> lexy::callback<int>(
+                                      [](std::vector<int>&& vec) { return int(vec.size()); });
+};
+
+std::string read_all(std::FILE* file)
+{
+    std::string result;
+    std::rewind(file);
+    for (auto c = std::fgetc(file); c != EOF; c = std::fgetc(file))
+        result.push_back(char(c));
+    return result;
+}
+} // namespace
+
+TEST_CASE("trace_parse")
+{
+    lexy::trace_profile profile;
+
+    SUBCASE("success")
+    {
+        auto result = lexy::trace_parse<items>(profile, lexy::zstring_input("ababab;"), lexy::noop);
+        REQUIRE(result);
+        CHECK(result.value() == 3);
+
+        auto stats = profile.productions();
+        REQUIRE(stats.size() == 2);
+
+        CHECK(stats[0].name == "items");
+        CHECK(stats[0].count == 1);
+        CHECK(stats[0].failures == 0);
+        CHECK(stats[0].bytes == 7);
+        CHECK(stats[0].inclusive >= stats[0].exclusive);
+        CHECK(stats[0].inclusive >= stats[1].inclusive);
+
+        CHECK(stats[1].name == "item");
+        CHECK(stats[1].count == 3);
+        CHECK(stats[1].failures == 0);
+        CHECK(stats[1].bytes == 6);
+        CHECK(stats[1].inclusive == stats[1].exclusive);
+    }
+    SUBCASE("failure")
+    {
+        auto result = lexy::trace_parse<items>(profile, lexy::zstring_input("aba"), lexy::noop);
+        CHECK(!result);
+
+        auto stats = profile.productions();
+        REQUIRE(stats.size() == 2);
+        CHECK(stats[0].count == 1);
+        CHECK(stats[0].failures == 1);
+        CHECK(stats[0].bytes == 0);
+        CHECK(stats[1].count == 1);
+        CHECK(stats[1].failures == 0);
+        CHECK(stats[1].bytes == 2);
+    }
+    SUBCASE("accumulation")
+    {
+        lexy::trace_parse<items>(profile, lexy::zstring_input("ab;"), lexy::noop);
+        lexy::trace_parse<items>(profile, lexy::zstring_input("abab;"), lexy::noop);
+
+        auto stats = profile.productions();
+        REQUIRE(stats.size() == 2);
+        CHECK(stats[0].count == 2);
+        CHECK(stats[1].count == 3);
+
+        profile.clear();
+        CHECK(profile.productions().empty());
+    }
+    SUBCASE("output")
+    {
+        lexy::trace_parse<items>(profile, lexy::zstring_input("ababab;"), lexy::noop);
+
+        auto folded = std::tmpfile();
+        REQUIRE(folded);
+        profile.write_folded(folded);
+        auto folded_str = read_all(folded);
+        std::fclose(folded);
+        CHECK(folded_str.find("items;item ") != std::string::npos);
+
+        auto json = std::tmpfile();
+        REQUIRE(json);
+        profile.write_json(json);
+        auto json_str = read_all(json);
+        std::fclose(json);
+        CHECK(json_str.find("{\"name\": \"items\", \"count\": 1, \"failures\": 0, \"bytes\": 7")
+              != std::string::npos);
+        CHECK(json_str.find("{\"name\": \"item\", \"count\": 3, \"failures\": 0, \"bytes\": 6")
+              != std::string::npos);
+    }
+}
+
+TEST_CASE("trace_validate")
+{
+    lexy::trace_profile profile;
+
+    auto result = lexy::trace_validate<items>(profile, lexy::zstring_input("abab;"), lexy::noop);
+    CHECK(result);
+
+    auto stats = profile.productions();
+    REQUIRE(stats.size() == 2);
+    CHECK(stats[0].count == 1);
+    CHECK(stats[0].bytes == 5);
+    CHECK(stats[1].count == 2);
+    CHECK(stats[1].bytes == 4);
+}
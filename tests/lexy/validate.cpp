@@ -6,6 +6,10 @@
 
 #include <doctest/doctest.h>
 #include <lexy/dsl/capture.hpp>
+#include <lexy/dsl/code_point.hpp>
+#include <lexy/dsl/delimited.hpp>
+#include <lexy/dsl/eof.hpp>
+#include <lexy/dsl/integer.hpp>
 #include <lexy/dsl/list.hpp>
 #include <lexy/dsl/literal.hpp>
 #include <lexy/dsl/production.hpp>
@@ -22,6 +26,22 @@ struct prod_b
 {
     static constexpr auto rule = LEXY_LIT("(") + capture(lexy::dsl::p<prod_a>) + LEXY_LIT(")");
 };
+
+struct prod_int
+{
+    static constexpr auto rule = [] {
+        auto digits = lexy::dsl::digits<>.sep(LEXY_LIT("'"));
+        return lexy::dsl::integer<unsigned char>(digits) + lexy::dsl::eof;
+    }();
+};
+struct prod_cp
+{
+    static constexpr auto rule = lexy::dsl::code_point.capture() + lexy::dsl::eof;
+};
+struct prod_quoted
+{
+    static constexpr auto rule = lexy::dsl::quoted(lexy::dsl::code_point) + lexy::dsl::eof;
+};
 } // namespace
 
 TEST_CASE("validate")
@@ -116,3 +136,39 @@ TEST_CASE("validate")
     }
 }
 
+TEST_CASE("validate discards values")
+{
+    CHECK(lexy::_handler_discards_values<lexy::_validate_handler<lexy::string_input<>, int>>);
+
+    auto validate = [](auto production, const char* str) {
+        auto input = lexy::zstring_input<lexy::utf8_encoding>(str);
+        return lexy::validate<decltype(production)>(input, lexy::noop).has_value();
+    };
+
+    SUBCASE("integer")
+    {
+        CHECK(validate(prod_int{}, "0"));
+        CHECK(validate(prod_int{}, "42"));
+        CHECK(validate(prod_int{}, "255"));
+        CHECK(validate(prod_int{}, "0'0'2'5'5"));
+        CHECK(validate(prod_int{}, "000255"));
+
+        // Overflow is still detected.
+        CHECK(!validate(prod_int{}, "256"));
+        CHECK(!validate(prod_int{}, "2'5'6"));
+        CHECK(!validate(prod_int{}, "1000"));
+        CHECK(!validate(prod_int{}, "0001000"));
+    }
+    SUBCASE("code point")
+    {
+        CHECK(validate(prod_cp{}, "a"));
+        CHECK(!validate(prod_cp{}, ""));
+        CHECK(!validate(prod_cp{}, "\x80"));
+    }
+    SUBCASE("delimited")
+    {
+        CHECK(validate(prod_quoted{}, "\"\""));
+        CHECK(validate(prod_quoted{}, "\"abc\""));
+        CHECK(!validate(prod_quoted{}, "\"abc"));
+    }
+}